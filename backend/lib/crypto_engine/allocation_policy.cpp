@@ -0,0 +1,261 @@
+#include "allocation_policy.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+const size_t AllocationPolicyEngine::NPOS;
+
+namespace
+{
+    const NodeLoadInfo DEFAULT_LOAD = {0.0, 1.0, 1.0};
+}
+
+AllocationPolicyEngine::AllocationPolicyEngine() : policy_(AllocationPolicyKind::FirstMatch), virtualTime_(0.0)
+{
+}
+
+AllocationPolicyEngine::~AllocationPolicyEngine() = default;
+
+void AllocationPolicyEngine::setPolicy(AllocationPolicyKind kind)
+{
+    policy_.store(kind);
+}
+
+void AllocationPolicyEngine::updateNodeLoads(const vector<string> &nodeIds, const vector<NodeLoadInfo> &infos)
+{
+    lock_guard<mutex> lock(mtx_);
+    for (size_t i = 0; i < nodeIds.size() && i < infos.size(); i++)
+    {
+        stateOf(nodeIds[i]).info = infos[i];
+    }
+}
+
+bool AllocationPolicyEngine::nodeLoad(const string &nodeId, NodeLoadInfo &info) const
+{
+    lock_guard<mutex> lock(mtx_);
+    auto it = nodes_.find(nodeId);
+    if (it == nodes_.end())
+    {
+        return false;
+    }
+    info = it->second.info;
+    return true;
+}
+
+bool AllocationPolicyEngine::removeNode(const string &nodeId)
+{
+    lock_guard<mutex> lock(mtx_);
+    return nodes_.erase(nodeId) > 0;
+}
+
+size_t AllocationPolicyEngine::select(const vector<string> &candidates, double demand)
+{
+    if (candidates.empty())
+    {
+        return NPOS;
+    }
+    // 首个匹配策略不依赖负载信息，无需加锁
+    if (policy_.load() == AllocationPolicyKind::FirstMatch)
+    {
+        return 0;
+    }
+
+    // 对候选节点做一次线性扫描，取排序键最小者；键相同时取先出现的，重复的ID键相同，自然落到首次出现的下标
+    AllocationPolicyKind kind = policy_.load();
+    lock_guard<mutex> lock(mtx_);
+    size_t best = NPOS;
+    NodeState *bestState = nullptr;
+    double bestKey = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        NodeState &state = stateOf(candidates[i]);
+        double key = rankKey(kind, state, demand);
+        if (key < bestKey)
+        {
+            best = i;
+            bestState = &state;
+            bestKey = key;
+        }
+    }
+
+    if (bestState)
+    {
+        chargeLocked(*bestState, demand);
+    }
+    return best;
+}
+
+AllocationRanking AllocationPolicyEngine::rank(const vector<string> &candidates, double demand)
+{
+    AllocationRanking ranking;
+    ranking.slotOf.resize(candidates.size());
+
+    unordered_map<string, size_t> slotOf;
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        auto inserted = slotOf.emplace(candidates[i], ranking.slotNodes.size());
+        if (inserted.second)
+        {
+            ranking.slotNodes.push_back(candidates[i]);
+        }
+        ranking.slotOf[i] = inserted.first->second;
+    }
+
+    AllocationPolicyKind kind = policy_.load();
+    ranking.keys.resize(ranking.slotNodes.size());
+    if (kind == AllocationPolicyKind::FirstMatch)
+    {
+        for (size_t slot = 0; slot < ranking.keys.size(); slot++)
+        {
+            ranking.keys[slot] = static_cast<double>(slot);
+        }
+        return ranking;
+    }
+
+    lock_guard<mutex> lock(mtx_);
+    for (size_t slot = 0; slot < ranking.keys.size(); slot++)
+    {
+        ranking.keys[slot] = rankKey(kind, stateOf(ranking.slotNodes[slot]), demand);
+    }
+    return ranking;
+}
+
+void AllocationPolicyEngine::charge(const string &nodeId, double demand)
+{
+    if (policy_.load() == AllocationPolicyKind::FirstMatch)
+    {
+        return;
+    }
+    lock_guard<mutex> lock(mtx_);
+    chargeLocked(stateOf(nodeId), demand);
+}
+
+void AllocationPolicyEngine::chargeLocked(NodeState &state, double demand)
+{
+    state.info.load += demand;
+    if (policy_.load() == AllocationPolicyKind::WeightedRoundRobin && state.info.weight > 0)
+    {
+        virtualTime_ = state.pass;
+        state.pass += 1.0 / state.info.weight;
+    }
+}
+
+double AllocationPolicyEngine::rankKey(AllocationPolicyKind kind, const NodeState &state, double demand)
+{
+    const double unavailable = numeric_limits<double>::infinity();
+    switch (kind)
+    {
+    case AllocationPolicyKind::LeastLoaded:
+        return state.info.capacity > 0 ? state.info.load / state.info.capacity : unavailable;
+    case AllocationPolicyKind::WeightedRoundRobin:
+        return state.info.weight > 0 ? state.pass : unavailable;
+    case AllocationPolicyKind::BinPacking:
+    {
+        double remaining = state.info.capacity - state.info.load;
+        return remaining >= demand ? remaining : unavailable;
+    }
+    default:
+        return 0.0;
+    }
+}
+
+AllocationPolicyEngine::NodeState &AllocationPolicyEngine::stateOf(const string &nodeId)
+{
+    auto it = nodes_.find(nodeId);
+    if (it == nodes_.end())
+    {
+        NodeState state;
+        state.info = DEFAULT_LOAD;
+        state.pass = virtualTime_;
+        it = nodes_.emplace(nodeId, state).first;
+    }
+    return it->second;
+}
+
+const char *allocationPolicyName(AllocationPolicyKind kind)
+{
+    switch (kind)
+    {
+    case AllocationPolicyKind::LeastLoaded:
+        return "least_loaded";
+    case AllocationPolicyKind::WeightedRoundRobin:
+        return "weighted_round_robin";
+    case AllocationPolicyKind::BinPacking:
+        return "bin_packing";
+    default:
+        return "first_match";
+    }
+}
+
+bool parseAllocationPolicy(const string &name, AllocationPolicyKind &kind)
+{
+    static const AllocationPolicyKind kinds[] = {
+        AllocationPolicyKind::FirstMatch,
+        AllocationPolicyKind::LeastLoaded,
+        AllocationPolicyKind::WeightedRoundRobin,
+        AllocationPolicyKind::BinPacking};
+    for (AllocationPolicyKind candidate : kinds)
+    {
+        if (name == allocationPolicyName(candidate))
+        {
+            kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TopKCollector::offer(double key, size_t slot, size_t index)
+{
+    if (k_ == 0 || key == numeric_limits<double>::infinity())
+    {
+        return;
+    }
+
+    // 同一槽位的键相同，只需保留最小的候选下标(k通常很小，线性查找即可)
+    for (Entry &entry : heap_)
+    {
+        if (entry.slot == slot)
+        {
+            entry.index = min(entry.index, index);
+            return;
+        }
+    }
+
+    Entry entry = {key, slot, index};
+    if (heap_.size() < k_)
+    {
+        heap_.push_back(entry);
+        push_heap(heap_.begin(), heap_.end(), ranksBefore);
+        return;
+    }
+    if (ranksBefore(entry, heap_.front()))
+    {
+        pop_heap(heap_.begin(), heap_.end(), ranksBefore);
+        heap_.back() = entry;
+        push_heap(heap_.begin(), heap_.end(), ranksBefore);
+    }
+}
+
+void TopKCollector::merge(const TopKCollector &other)
+{
+    for (const Entry &entry : other.heap_)
+    {
+        offer(entry.key, entry.slot, entry.index);
+    }
+}
+
+vector<TopKCollector::Entry> TopKCollector::sorted() const
+{
+    vector<Entry> entries = heap_;
+    sort(entries.begin(), entries.end(), ranksBefore);
+    return entries;
+}
+
+bool TopKCollector::ranksBefore(const Entry &a, const Entry &b)
+{
+    // 键小者在前；作为堆的比较函数时堆顶为当前最差的候选
+    return a.key < b.key || (a.key == b.key && a.slot < b.slot);
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 匹配完成后在候选节点中选择目标节点的策略
+ */
+enum class AllocationPolicyKind
+{
+    FirstMatch,         // 第一个匹配的节点(原有行为)
+    LeastLoaded,        // 负载/容量比最低的节点
+    WeightedRoundRobin, // 按权重轮转(步幅调度)
+    BinPacking          // 剩余容量能容纳需求的节点中剩余容量最小的(最佳适配)
+};
+
+/**
+ * @brief 节点的负载信息，由调用方定期上报
+ */
+struct NodeLoadInfo
+{
+    double load;     // 当前负载
+    double capacity; // 总容量
+    double weight;   // 轮转权重，不大于0的节点不参与轮转
+};
+
+/**
+ * @brief 某一时刻候选节点在当前策略下的排序键
+ */
+struct AllocationRanking
+{
+    std::vector<size_t> slotOf;         // 候选下标 -> 去重后的节点槽位(按首次出现的顺序编号)
+    std::vector<std::string> slotNodes; // 槽位 -> 节点ID
+    std::vector<double> keys;           // 槽位 -> 排序键，越小越优先，不可选的节点为无穷大
+};
+
+/**
+ * @brief 有界的前k名收集器
+ *
+ * 保留排序键最小的k个不同槽位(键相同时槽位小的优先)，内部为大小不超过k的最大堆。
+ * 同一槽位多次出现时只保留最小的候选下标。本类本身不加锁。
+ */
+class TopKCollector
+{
+public:
+    struct Entry
+    {
+        double key;
+        size_t slot;
+        size_t index; // 候选下标
+    };
+
+    explicit TopKCollector(size_t k) : k_(k) {}
+
+    /**
+     * @brief 提交一个候选
+     */
+    void offer(double key, size_t slot, size_t index);
+
+    /**
+     * @brief 合并另一个收集器的结果
+     */
+    void merge(const TopKCollector &other);
+
+    /**
+     * @brief 按排序键升序返回收集到的候选
+     */
+    std::vector<Entry> sorted() const;
+
+private:
+    static bool ranksBefore(const Entry &a, const Entry &b);
+
+    size_t k_;
+    std::vector<Entry> heap_; // 最大堆，堆顶为当前第k名
+};
+
+/**
+ * @brief 分配策略引擎
+ *
+ * 维护各节点的负载、容量与权重，在匹配的候选节点中按当前策略选出目标节点。
+ * 每次选择对m个候选节点做一次线性扫描(O(m))，负载更新为O(1)。
+ * 被选中的节点立即记入本次需求(load += demand)，避免两次负载上报之间的请求
+ * 全部落到同一节点；调用方下次上报的负载会覆盖这一估计值。
+ * 未上报过负载的候选节点按负载0、容量与权重为1处理。
+ */
+class AllocationPolicyEngine
+{
+public:
+    static const size_t NPOS = static_cast<size_t>(-1);
+
+    AllocationPolicyEngine();
+    ~AllocationPolicyEngine();
+
+    /**
+     * @brief 设置分配策略
+     */
+    void setPolicy(AllocationPolicyKind kind);
+
+    /**
+     * @brief 当前分配策略
+     */
+    AllocationPolicyKind policy() const { return policy_.load(); }
+
+    /**
+     * @brief 批量更新节点负载信息
+     * @param nodeIds 节点ID列表
+     * @param infos 与nodeIds一一对应的负载信息
+     */
+    void updateNodeLoads(const std::vector<std::string> &nodeIds, const std::vector<NodeLoadInfo> &infos);
+
+    /**
+     * @brief 查询节点负载信息
+     * @return 节点是否有记录
+     */
+    bool nodeLoad(const std::string &nodeId, NodeLoadInfo &info) const;
+
+    /**
+     * @brief 删除节点的负载记录
+     */
+    bool removeNode(const std::string &nodeId);
+
+    /**
+     * @brief 在候选节点中选择一个，并为其记入需求
+     * @param candidates 候选节点ID(可重复，重复的ID视为同一节点)
+     * @param demand 本次分配的需求量
+     * @return 选中节点在candidates中首次出现的下标，没有可用节点时返回NPOS
+     */
+    size_t select(const std::vector<std::string> &candidates, double demand = 1.0);
+
+    /**
+     * @brief 取得候选节点在当前策略下的排序键快照，供并行扫描时无锁排序
+     * @param candidates 候选节点ID(可重复)
+     * @param demand 需求量(最佳适配策略据此排除容量不足的节点)
+     */
+    AllocationRanking rank(const std::vector<std::string> &candidates, double demand = 1.0);
+
+    /**
+     * @brief 为选中的节点记入需求(与select选中节点时的更新相同)
+     */
+    void charge(const std::string &nodeId, double demand = 1.0);
+
+private:
+    struct NodeState
+    {
+        NodeLoadInfo info;
+        double pass; // 轮转策略的步幅进度，值最小的节点下一个被选中
+    };
+
+    AllocationPolicyEngine(const AllocationPolicyEngine &) = delete;
+    AllocationPolicyEngine &operator=(const AllocationPolicyEngine &) = delete;
+
+    NodeState &stateOf(const std::string &nodeId);
+    void chargeLocked(NodeState &state, double demand);
+    static double rankKey(AllocationPolicyKind kind, const NodeState &state, double demand);
+
+    std::atomic<AllocationPolicyKind> policy_;
+    mutable std::mutex mtx_;
+    std::unordered_map<std::string, NodeState> nodes_;
+    double virtualTime_; // 最近一次被选中节点的步幅进度，新节点从此处开始参与轮转
+};
+
+/**
+ * @brief 分配策略的文本形式("first_match"/"least_loaded"/"weighted_round_robin"/"bin_packing")
+ */
+const char *allocationPolicyName(AllocationPolicyKind kind);
+
+/**
+ * @brief 由文本形式解析分配策略
+ * @return 名称是否有效
+ */
+bool parseAllocationPolicy(const std::string &name, AllocationPolicyKind &kind);
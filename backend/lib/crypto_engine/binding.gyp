@@ -7,6 +7,17 @@
       "sources": [
         "crypto_engine.cpp",
         "crypto_engine_impl.cpp",
+        "unique_id.cpp",
+        "match_cache.cpp",
+        "pairing_context.cpp",
+        "parallel_for.cpp",
+        "point_accumulator.cpp",
+        "compressed_gt.cpp",
+        "task_scheduler.cpp",
+        "allocation_policy.cpp",
+        "cancellation.cpp",
+        "keyword_query.cpp",
+        "group_tree.cpp",
         "node_binding.cpp"
       ],
       "include_dirs": [
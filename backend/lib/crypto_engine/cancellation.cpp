@@ -0,0 +1,72 @@
+#include "cancellation.h"
+
+using namespace std;
+
+CancellationToken::CancellationToken() : cancelled_(false), deadline_(0)
+{
+}
+
+void CancellationToken::cancel()
+{
+    cancelled_.store(true);
+}
+
+void CancellationToken::setDeadline(chrono::steady_clock::time_point deadline)
+{
+    int64_t ticks = chrono::duration_cast<chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    // 0保留为"没有截止时间"
+    deadline_.store(ticks != 0 ? ticks : 1);
+}
+
+void CancellationToken::setTimeout(chrono::milliseconds timeout)
+{
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    int64_t nowTicks = chrono::duration_cast<chrono::nanoseconds>(now.time_since_epoch()).count();
+
+    // 换算为纳秒后超出int64范围时截止时间取最大值，避免溢出成已过去的时间
+    if (timeout.count() > (INT64_MAX - nowTicks) / 1000000)
+    {
+        deadline_.store(INT64_MAX);
+        return;
+    }
+    setDeadline(now + timeout);
+}
+
+bool CancellationToken::stopRequested() const
+{
+    if (cancelled_.load(memory_order_relaxed))
+    {
+        return true;
+    }
+    int64_t deadline = deadline_.load(memory_order_relaxed);
+    if (deadline == 0)
+    {
+        return false;
+    }
+    int64_t now = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    return now >= deadline;
+}
+
+BatchStatus CancellationToken::stopReason() const
+{
+    return cancelled_.load() ? BatchStatus::Cancelled : BatchStatus::DeadlineExceeded;
+}
+
+const CancellationToken &CancellationToken::none()
+{
+    static const CancellationToken token;
+    return token;
+}
+
+const char *batchStatusName(BatchStatus status)
+{
+    switch (status)
+    {
+    case BatchStatus::Cancelled:
+        return "cancelled";
+    case BatchStatus::DeadlineExceeded:
+        return "deadline_exceeded";
+    default:
+        return "completed";
+    }
+}
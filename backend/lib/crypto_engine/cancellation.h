@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief 批量操作的结束状态
+ */
+enum class BatchStatus
+{
+    Completed,       // 全部完成
+    Cancelled,       // 被调用方取消，只返回了部分结果
+    DeadlineExceeded // 超过截止时间，只返回了部分结果
+};
+
+/**
+ * @brief 批量操作的取消令牌
+ *
+ * 调用方可随时从任意线程调用cancel()，或预先设置截止时间；批量操作在处理
+ * 每个元素之前检查stopRequested()，一旦为真就放弃剩余的元素。
+ */
+class CancellationToken
+{
+public:
+    CancellationToken();
+
+    /**
+     * @brief 请求取消
+     */
+    void cancel();
+
+    /**
+     * @brief 设置截止时间
+     */
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * @brief 设置从现在起的超时时间，过长的超时按最远的截止时间处理
+     */
+    void setTimeout(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 是否应停止剩余的工作(已取消或已超过截止时间)
+     */
+    bool stopRequested() const;
+
+    /**
+     * @brief 工作未全部完成时应报告的状态
+     */
+    BatchStatus stopReason() const;
+
+    /**
+     * @brief 永不取消的令牌，用于不带取消参数的调用
+     */
+    static const CancellationToken &none();
+
+private:
+    std::atomic<bool> cancelled_;
+    std::atomic<int64_t> deadline_; // steady_clock纳秒计数，0表示没有截止时间
+};
+
+/**
+ * @brief 批量操作状态的文本形式("completed"/"cancelled"/"deadline_exceeded")
+ */
+const char *batchStatusName(BatchStatus status);
@@ -0,0 +1,159 @@
+#include "compressed_gt.h"
+#include <atomic>
+
+using namespace std;
+
+namespace
+{
+    // 是否启用压缩(自检通过后置为true)
+    atomic<bool> compressionEnabled(false);
+
+    // GF(q^2)元素 x + y*ω，其中 ω^2 = ω + 1
+    struct Fq2
+    {
+        GF2m x, y;
+    };
+
+    Fq2 add(const Fq2 &a, const Fq2 &b)
+    {
+        return Fq2{a.x + b.x, a.y + b.y};
+    }
+
+    Fq2 mul(const Fq2 &a, const Fq2 &b)
+    {
+        // (a0 + a1ω)(b0 + b1ω) = (a0b0 + a1b1) + (a0b1 + a1b0 + a1b1)ω，三次GF(q)乘法
+        GF2m xx = a.x * b.x;
+        GF2m yy = a.y * b.y;
+        return Fq2{xx + yy, (a.x + a.y) * (b.x + b.y) + xx};
+    }
+
+    Fq2 inverse(const Fq2 &a)
+    {
+        // 共轭为 (x+y) + yω，范数 x^2 + xy + y^2 属于GF(q)
+        GF2m sum = a.x + a.y;
+        GF2m norm = a.x * sum + a.y * a.y;
+        return Fq2{sum / norm, a.y / norm};
+    }
+
+    bool isZero(const Fq2 &a)
+    {
+        return a.x.iszero() && a.y.iszero();
+    }
+
+    // g = a0 + a1X + a2X^2 + a3X^3 (模 X^4+X+1)，由 X^2 = X + ω 改写为 A + B*X
+    bool pack(const GT &value, GF2m &c0, GF2m &c1)
+    {
+        GT copy(value);
+        GF2m a0, a1, a2, a3;
+        copy.g.get(a0, a1, a2, a3);
+
+        Fq2 A = {a0, a2 + a3};
+        Fq2 B = {a1 + a2 + a3, a3};
+        if (isZero(B))
+        {
+            // 范数为1且B为0的元素只有单位元
+            return false;
+        }
+
+        Fq2 c = mul(add(A, Fq2{GF2m(1), GF2m(0)}), inverse(B));
+        c0 = c.x;
+        c1 = c.y;
+        return true;
+    }
+
+    GT unpack(const GF2m &c0, const GF2m &c1)
+    {
+        // g = (c+X)/(c+X+1)：B = 1/(c^2 + c + ω)，A = (c^2 + ω)*B
+        Fq2 c = {c0, c1};
+        Fq2 omega = {GF2m(0), GF2m(1)};
+        Fq2 c2 = mul(c, c);
+        Fq2 B = inverse(add(add(c2, c), omega));
+        Fq2 A = mul(add(c2, omega), B);
+
+        GT out;
+        out.g.set(A.x, B.x + A.y, A.y + B.y, B.y);
+        return out;
+    }
+
+    // MIRACL为每个域元素分配的大数空间(mirvar按当前域的字长分配)
+    size_t fieldElementHeapBytes()
+    {
+        return mr_size(get_mip()->nib - 1);
+    }
+}
+
+CompressedGT::CompressedGT() : identity(true)
+{
+}
+
+CompressedGT::CompressedGT(const GT &value) : identity(false)
+{
+    if (!compressionEnabled.load(memory_order_relaxed))
+    {
+        full = make_shared<GT>(value);
+        return;
+    }
+    identity = !pack(value, c0, c1);
+}
+
+GT CompressedGT::value() const
+{
+    if (full)
+    {
+        return *full;
+    }
+    if (identity)
+    {
+        return GT(1);
+    }
+    return unpack(c0, c1);
+}
+
+size_t CompressedGT::residentBytes() const
+{
+    size_t bytes = sizeof(CompressedGT) + 2 * fieldElementHeapBytes();
+    if (full)
+    {
+        bytes += uncompressedBytes();
+    }
+    return bytes;
+}
+
+size_t CompressedGT::uncompressedBytes()
+{
+    return sizeof(GT) + 4 * fieldElementHeapBytes();
+}
+
+bool CompressedGT::detectCompression(PFC &pfc)
+{
+    if (compressionEnabled.load())
+    {
+        return true;
+    }
+
+    // 两个独立的配对值及其积都须能原样还原
+    G1 a, b, c;
+    pfc.random(a);
+    pfc.random(b);
+    pfc.random(c);
+    GT samples[3] = {pfc.pairing(a, b), pfc.pairing(c, b), GT(1)};
+    samples[2] = samples[0] * samples[1];
+
+    for (const GT &sample : samples)
+    {
+        GF2m c0, c1;
+        if (!pack(sample, c0, c1) || unpack(c0, c1) != sample)
+        {
+            return false;
+        }
+    }
+
+    GF2m c0, c1;
+    if (pack(GT(1), c0, c1))
+    {
+        return false;
+    }
+
+    compressionEnabled.store(true);
+    return true;
+}
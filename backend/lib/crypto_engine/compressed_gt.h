@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "pairing_context.h"
+
+/**
+ * @brief GT元素的压缩存储形式(代数环面T2压缩)
+ *
+ * SS2配对的值位于 GF(q^4) = GF(2^4m) 中阶整除 q^2+1 的子群，即GF(q^2)上范数为1的元素。
+ * 记 GF(q^2) = GF(q)[ω]/(ω^2+ω+1)，GF(q^4) = GF(q^2)[X]/(X^2+X+ω)，则非单位元 g = A + B*X
+ * 可由一个GF(q^2)元素 c = (A+1)/B 表示，还原时 g = (c+X)/(c+X+1)。存储量为完整元素的一半，
+ * 解压只需一次GF(q^2)求逆与少量乘法。
+ *
+ * 压缩依赖MIRACL以 GF(2^m)[X]/(X^4+X+1) 表示GT，systemSetup时由detectCompression用
+ * 真实的配对值自检；自检未通过时退化为保存完整元素，结果不受影响。发布后不可变。
+ */
+class CompressedGT
+{
+public:
+    /**
+     * @brief 构造单位元
+     */
+    CompressedGT();
+
+    /**
+     * @brief 压缩一个配对值(或配对值的积与幂)
+     */
+    explicit CompressedGT(const GT &value);
+
+    /**
+     * @brief 解压为完整的GT元素
+     */
+    GT value() const;
+
+    /**
+     * @brief 本对象常驻内存的字节数(含MIRACL为域元素分配的空间)
+     */
+    size_t residentBytes() const;
+
+    /**
+     * @brief 一个完整GT元素常驻内存的字节数(不含幂预计算表)
+     */
+    static size_t uncompressedBytes();
+
+    /**
+     * @brief 用随机配对值自检压缩公式，通过后启用压缩
+     * @param pfc 当前线程的配对上下文
+     * @return 是否启用了压缩
+     */
+    static bool detectCompression(PFC &pfc);
+
+private:
+    GF2m c0, c1;                    // 压缩值 c = c0 + c1*ω
+    bool identity;                  // 单位元没有压缩值
+    std::shared_ptr<const GT> full; // 自检未通过时保存的完整元素
+};
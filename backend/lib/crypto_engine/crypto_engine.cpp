@@ -38,6 +38,19 @@ std::pair<std::string, std::string> CryptoEngine::nodeRegistration(const std::st
     }
 }
 
+std::vector<std::pair<std::string, std::string>> CryptoEngine::nodeRegistrationBatch(const std::vector<std::string> &nodeIds)
+{
+    try
+    {
+        return impl->nodeRegistrationBatch(nodeIds);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "批量节点注册错误: " << e.what() << std::endl;
+        return std::vector<std::pair<std::string, std::string>>(nodeIds.size(), std::make_pair("", ""));
+    }
+}
+
 std::string CryptoEngine::groupGeneration(const std::vector<std::string> &nodeIds)
 {
     try
@@ -90,6 +103,19 @@ std::string CryptoEngine::encapsulateKeyword(const std::string &keyword, const s
     }
 }
 
+std::vector<std::string> CryptoEngine::encapsulateKeywordBatch(const std::vector<std::string> &keywords, const std::string &groupId)
+{
+    try
+    {
+        return impl->encapsulateKeywordBatch(keywords, groupId);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "批量关键词封装错误: " << e.what() << std::endl;
+        return std::vector<std::string>(keywords.size());
+    }
+}
+
 bool CryptoEngine::verifyKeywordMatch(const std::string &trapdoor, const std::string &encryptedMetadata)
 {
     try
@@ -103,6 +129,20 @@ bool CryptoEngine::verifyKeywordMatch(const std::string &trapdoor, const std::st
     }
 }
 
+std::vector<bool> CryptoEngine::verifyKeywordMatchBatch(const std::vector<std::string> &trapdoors,
+                                                        const std::vector<std::string> &encryptedMetadataList)
+{
+    try
+    {
+        return impl->verifyKeywordMatchBatch(trapdoors, encryptedMetadataList);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "批量关键词匹配验证错误: " << e.what() << std::endl;
+        return std::vector<bool>(trapdoors.size(), false);
+    }
+}
+
 std::string CryptoEngine::allocateResourcesAccordingToKeywords(
     const std::string &trapdoor,
     const std::vector<std::string> &encryptedMetadataList,
@@ -118,3 +158,42 @@ std::string CryptoEngine::allocateResourcesAccordingToKeywords(
         return "";
     }
 }
+
+bool CryptoEngine::releaseTrapdoor(const std::string &trapdoor)
+{
+    try
+    {
+        return impl->releaseTrapdoor(trapdoor);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "陷门释放错误: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool CryptoEngine::releaseEncapsulation(const std::string &encryptedMetadata)
+{
+    try
+    {
+        return impl->releaseEncapsulation(encryptedMetadata);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "封装数据释放错误: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+size_t CryptoEngine::setWorkerThreads(size_t count, size_t reservedInteractive)
+{
+    try
+    {
+        return impl->setWorkerThreads(count, reservedInteractive);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "工作线程设置错误: " << e.what() << std::endl;
+        return 0;
+    }
+}
@@ -41,6 +41,14 @@ public:
      */
     std::pair<std::string, std::string> nodeRegistration(const std::string &nodeId);
 
+    /**
+     * 批量节点注册 - 并行为多个节点生成密钥
+     *
+     * @param nodeIds 节点ID列表
+     * @return 与输入一一对应的密钥对列表
+     */
+    std::vector<std::pair<std::string, std::string>> nodeRegistrationBatch(const std::vector<std::string> &nodeIds);
+
     /**
      * 群组生成 - 基于节点列表生成群组
      *
@@ -74,6 +82,15 @@ public:
      */
     std::string encapsulateKeyword(const std::string &keyword, const std::string &groupId);
 
+    /**
+     * 批量封装关键词 - 后台导入使用，不占用交互请求的预留线程
+     *
+     * @param keywords 关键词列表
+     * @param groupId 群组ID
+     * @return 与输入一一对应的封装结果
+     */
+    std::vector<std::string> encapsulateKeywordBatch(const std::vector<std::string> &keywords, const std::string &groupId);
+
     /**
      * 验证关键词匹配 - 检查陷门是否匹配加密元数据
      *
@@ -83,6 +100,16 @@ public:
      */
     bool verifyKeywordMatch(const std::string &trapdoor, const std::string &encryptedMetadata);
 
+    /**
+     * 批量验证关键词匹配 - 多条独立的验证请求合并为一次并行执行
+     *
+     * @param trapdoors 陷门列表
+     * @param encryptedMetadataList 加密元数据列表，与陷门一一对应
+     * @return 与输入一一对应的匹配结果
+     */
+    std::vector<bool> verifyKeywordMatchBatch(const std::vector<std::string> &trapdoors,
+                                              const std::vector<std::string> &encryptedMetadataList);
+
     /**
      * 根据关键词匹配结果分配资源
      *
@@ -95,6 +122,31 @@ public:
                                                      const std::vector<std::string> &encryptedMetadataList,
                                                      const std::vector<std::string> &edgeNodeIds);
 
+    /**
+     * 释放陷门 - 同时清除与其相关的匹配结果缓存
+     *
+     * @param trapdoor 陷门
+     * @return 陷门是否存在并被释放
+     */
+    bool releaseTrapdoor(const std::string &trapdoor);
+
+    /**
+     * 释放封装数据 - 同时清除与其相关的匹配结果缓存
+     *
+     * @param encryptedMetadata 加密元数据
+     * @return 封装数据是否存在并被释放
+     */
+    bool releaseEncapsulation(const std::string &encryptedMetadata);
+
+    /**
+     * 设置引擎工作线程数 - 所有批量操作共用同一组工作线程
+     *
+     * @param count 工作线程数，0表示批量操作在调用线程上串行执行
+     * @param reservedInteractive 只执行交互请求的线程数，默认取总数的1/4
+     * @return 实际生效的工作线程数
+     */
+    size_t setWorkerThreads(size_t count, size_t reservedInteractive = static_cast<size_t>(-1));
+
 private:
     // 使用PIMPL模式，隐藏实现细节
     std::unique_ptr<CryptoEngineImpl> impl;
@@ -2,16 +2,32 @@
 #define AES_SECURITY 128 // AES-128安全级别
 
 #include "crypto_engine_impl.h"
+#include "unique_id.h"
+#include "match_cache.h"
+#include "pairing_context.h"
+#include "parallel_for.h"
+#include "task_scheduler.h"
+#include "point_accumulator.h"
+#include "engine_state.h"
+#include "allocation_policy.h"
+#include "keyword_query.h"
+#include "node_key_cache.h"
+#include "striped_lru_cache.h"
+#include "group_tree.h"
 #include <iostream>
 #include <ctime>
 #include <cstring>
 #include <vector>
 #include <mutex>
+#include <memory>
 #include <thread>
 #include <chrono>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <sstream>
+#include <algorithm>
+#include <atomic>
 
 // 包含MIRACL库头文件
 #include "../../../libs/miracl/include/mirdef.h"
@@ -23,37 +39,111 @@
 
 using namespace std;
 
+// 批量节点注册时每个并行块包含的节点数
+static const size_t NODE_REGISTRATION_GRAIN = 16;
+// 群组生成时每个并行块包含的成员数
+static const size_t GROUP_GENERATION_GRAIN = 64;
+// 批量验证时每个并行块包含的验证请求数
+static const size_t VERIFY_BATCH_GRAIN = 8;
+// 批量封装时每个并行块包含的关键字数
+static const size_t ENCAPSULATION_BATCH_GRAIN = 4;
+// 资源分配时每个并行块包含的加密元数据条数
+static const size_t ALLOCATION_MATCH_GRAIN = 8;
+// 多请求批量分配时每个分块包含的陷门数与加密元数据条数
+static const size_t BATCH_ALLOCATION_TRAPDOOR_TILE = 8;
+static const size_t BATCH_ALLOCATION_RECORD_TILE = 128;
+// 流式匹配时每个并行块包含的加密元数据条数(即回调的最大粒度)
+static const size_t STREAM_MATCH_GRAIN = 32;
+// 流式匹配每轮并行检查的块数(按参与线程数计)，一轮结束后才在调用线程上回调
+static const size_t STREAM_MATCH_WINDOW_PER_THREAD = 4;
+// 多关键词查询时每个并行块包含的加密元数据条数，以及按匹配率重排求值顺序的间隔
+static const size_t QUERY_MATCH_GRAIN = 16;
+static const size_t QUERY_REPLAN_INTERVAL = 64;
+// 陷门与封装数据缓存的容量，超出时按LRU淘汰(被淘汰的ID与已释放的ID一样不再可用)，同时清除其匹配结果
+static const size_t TRAPDOOR_CACHE_CAPACITY = 1 << 18;
+static const size_t ENC_CACHE_CAPACITY = 1 << 20;
+// 陷门记忆最多保存的(群组, 关键词)数
+static const size_t TRAPDOOR_MEMO_CAPACITY = 1 << 16;
+// 关键词GT底数缓存最多保存的(群组, 关键词)数，每个热点条目附带一张定基幂预计算表
+static const size_t KEYWORD_BASE_CACHE_CAPACITY = 2048;
+// H2(GroupID||keyword)缓存最多保存的(群组, 关键词)数
+static const size_t KEYWORD_POINT_CACHE_CAPACITY = 1 << 16;
+// 词表预计算时每个并行块包含的关键词数
+static const size_t VOCABULARY_GRAIN = 4;
+// 群组生成期间成员被重新注册时的最大重算次数
+static const int GROUP_GENERATION_ATTEMPTS = 3;
+
+// 陷门ID与封装ID的文本前缀
+static const string TRAPDOOR_ID_PREFIX = "td_";
+static const string ENC_ID_PREFIX = "enc_";
+
 // PrivateImpl类实现所有内部功能
 class CryptoEngineImpl::PrivateImpl
 {
 private:
-    // 密码学参数
-    PFC pfc; // 配对友好曲线
-    G1 P;    // 基点
-    G1 Ppub; // 系统公钥
-    Big s;   // 系统主密钥
-
-    // 状态管理
-    bool initialized; // 是否已初始化
-    mutex mtx;        // 并发互斥锁
-
-    // 映射表
-    map<string, G1> nodePrivateKeys;          // 节点ID -> 节点私钥
-    map<string, G1> nodePublicKeys;           // 节点ID -> 节点公钥qi
-    map<string, Big> nodeRandomValues;        // 节点ID -> 随机值xi
-    map<string, vector<string>> groupMembers; // 群组ID -> 成员节点ID列表
-    map<string, G1> groupPublicKeysR;         // 群组ID -> 群组公钥r部分
-    map<string, GT> groupPublicKeysPhi;       // 群组ID -> 群组公钥Phi部分
-
-    // 缓存映射
-    map<string, G1> trapdoorCache;       // trapdoorId -> 陷门G1元素
-    map<string, pair<G1, Big>> encCache; // encId -> (X, Y)元素对
+    // 封装数据缓存条目(X, Y)，多关键字封装的各关键字共享同一个X
+    struct EncRecord
+    {
+        G1 X;
+        vector<Big> Y; // 每个关键字一个Y
+    };
+
+    // 陷门记忆条目：记录生成时群组记录的版本号，群组版本变化后自动失效
+    struct TrapdoorMemoEntry
+    {
+        UniqueId trapdoorUid;
+        uint64_t groupVersion;
+    };
+
+    // 关键词GT底数条目 e(H2(GroupID||keyword), r)*Φ，同样以群组版本号判断是否失效
+    //
+    // 只用过一次的底数以压缩形式保存；成为热点后改存附带定基幂预计算表的完整元素(表需要完整的底数，
+    // 且表本身远大于底数)，两者只有一个非空
+    struct KeywordBase
+    {
+        shared_ptr<const CompressedGT> packed;
+        shared_ptr<const GT> table;
+        uint64_t groupVersion;
+    };
+
+    // 共享状态：密码学参数、节点与群组表以不可变快照发布(配对友好曲线PFC按线程持有，见threadPfc)
+    shared_ptr<const EngineState> state;
+    mutex writerMtx;   // 串行化写者(系统初始化、节点注册、群组生成)
+    mutex rotationMtx; // 串行化主密钥轮换(轮换的计算在写锁外进行)
+
+    // 缓存映射(分段加锁、容量有界，陷门与封装数据被淘汰时清除其匹配结果)
+    StripedLruCache<UniqueId, shared_ptr<const G1>, UniqueIdHash> trapdoorCache;   // trapdoorId -> 陷门G1元素(LRU)
+    StripedLruCache<UniqueId, shared_ptr<const EncRecord>, UniqueIdHash> encCache; // encId -> (X, Y)元素对(LRU)
+    StripedLruCache<string, TrapdoorMemoEntry> trapdoorMemo;                       // "群组ID|关键词" -> 已生成的陷门(LRU)
+    StripedLruCache<string, KeywordBase> keywordBases;                          // "群组ID|关键词" -> 封装用的GT底数(LRU)
+    StripedLruCache<string, shared_ptr<const G1>> keywordPoints;                // "群组ID|关键词" -> H2(GroupID||keyword)(LRU)
+    StripedMatchCache matchCache;                                               // (陷门ID, 封装ID) -> 匹配结果
+    AllocationPolicyEngine allocationPolicy;                                    // 匹配后的节点选择策略与节点负载
+    NodeKeyCache nodeKeyCache;                                                  // 派生密钥模式下按需重算的节点密钥(LRU)
+    shared_ptr<const NodeRecord> derivedNodeRecord;                             // 派生密钥模式下注册的节点共享的占位记录
 
 public:
     // 构造函数
-    PrivateImpl() : pfc(AES_SECURITY), initialized(false)
+    PrivateImpl() : state(make_shared<EngineState>()),
+                    trapdoorCache(TRAPDOOR_CACHE_CAPACITY,
+                                  [this](const UniqueId &trapdoorUid, const shared_ptr<const G1> &)
+                                  {
+                                      matchCache.eraseTrapdoor(trapdoorUid);
+                                  }),
+                    encCache(ENC_CACHE_CAPACITY,
+                             [this](const UniqueId &encUid, const shared_ptr<const EncRecord> &)
+                             {
+                                 matchCache.eraseEncapsulation(encUid);
+                             }),
+                    trapdoorMemo(TRAPDOOR_MEMO_CAPACITY), keywordBases(KEYWORD_BASE_CACHE_CAPACITY),
+                    keywordPoints(KEYWORD_POINT_CACHE_CAPACITY)
     {
-        // 初始化PFC对象时传入安全级别参数
+        // 确保当前线程的配对上下文已创建(MIRACL对象须在其后构造)
+        threadPfc();
+
+        shared_ptr<NodeRecord> marker = make_shared<NodeRecord>();
+        marker->derived = true;
+        derivedNodeRecord = marker;
     }
 
     // 析构函数
@@ -63,38 +153,68 @@ public:
     }
 
     // 1. 系统初始化 (Setup)
-    bool systemSetup(int securityLevel)
+    bool systemSetup(int securityLevel, int nodeTag)
     {
-        lock_guard<mutex> lock(mtx);
+        lock_guard<mutex> lock(writerMtx);
+        PFC &pfc = threadPfc();
 
         try
         {
             // 已初始化则直接返回
-            if (initialized)
+            if (snapshot()->initialized)
             {
                 return true;
             }
 
+            if (nodeTag > 0xFFFF)
+            {
+                cerr << "错误: 节点标记超出16位范围: " << nodeTag << endl;
+                return false;
+            }
+            if (nodeTag >= 0)
+            {
+                UniqueIdGenerator::instance().setNodeTag(static_cast<uint16_t>(nodeTag));
+            }
+
             // 初始化随机数生成器
             time_t seed;
             time(&seed);
             irand((long)seed);
 
+            shared_ptr<EngineState> next = beginWrite();
+
             // 随机选择基点P
-            pfc.random(P);
+            pfc.random(next->P);
 
             // 选择系统主密钥s
-            pfc.random(s);
+            pfc.random(next->s);
             // 确保s不为0
-            while (s == 0)
+            while (next->s == 0)
             {
-                pfc.random(s);
+                pfc.random(next->s);
             }
 
             // 计算系统公钥 Ppub = s*P
-            Ppub = pfc.mult(P, s);
+            next->Ppub = pfc.mult(next->P, next->s);
+
+            // 派生密钥模式下派生节点随机值xi的PRF密钥
+            pfc.random(next->nodeKeySeed);
+            next->keyEpoch = 1;
 
-        initialized = true;
+            // 自检射影坐标点加公式，通过后点累加改在射影坐标下进行
+            if (!PointAccumulator::detectCurveModel(pfc))
+            {
+                cerr << "警告: 射影坐标自检未通过，点累加使用仿射坐标" << endl;
+            }
+
+            // 自检GT环面压缩公式，通过后节点分量与群组公钥Φ以压缩形式存储
+            if (!CompressedGT::detectCompression(pfc))
+            {
+                cerr << "警告: GT压缩自检未通过，群组公钥以完整形式存储" << endl;
+            }
+
+            next->initialized = true;
+            publish(next);
             cout << "系统初始化完成，安全级别: " << securityLevel << endl;
             return true;
         }
@@ -105,50 +225,162 @@ public:
         }
     }
 
-    // 2. 节点注册 (NodeReg)
-    pair<string, string> nodeRegistration(const string &nodeId)
+    // 1b. 主密钥轮换 - 在快照上并行重算全部节点私钥与群组公钥，完成后原子地切换到新纪元
+    //
+    // 取新主密钥 s' 并令 k = s'/s，则 Ppub' = k*Ppub，si' = k*si，e(qi, Ppub') = e(qi, Ppub)^k，Φ' = Φ^k；
+    // xi、xi*P 与群组公钥r与主密钥无关，保持不变。计算期间读者与其他写者照常工作；已发出的陷门与
+    // 封装数据仍在旧纪元内互相匹配，切换后生成的陷门只匹配新纪元的封装数据。
+    uint64_t rotateMasterKey(const CancellationToken &token, BatchStatus &status)
     {
-        lock_guard<mutex> lock(mtx);
+        status = BatchStatus::Completed;
+        lock_guard<mutex> rotation(rotationMtx);
+        PFC &pfc = threadPfc();
+        shared_ptr<const EngineState> base = snapshot();
 
-        if (!initialized)
+        if (!base->initialized)
         {
             cerr << "错误: 系统未初始化" << endl;
-            return make_pair("", "");
+            return 0;
         }
 
         try
         {
-            G1 qi;
-            char idStr[256] = {0};
-            strcpy(idStr, nodeId.c_str());
-            pfc.hash_and_map(qi, idStr);
+            ScopedTaskPriority priority(TaskPriority::Bulk);
+
+            Big order = pfc.order();
+            Big s;
+            pfc.random(s);
+            while (s == 0 || s == base->s)
+            {
+                pfc.random(s);
+            }
+            Big k = modmult(s, inverse(base->s, order), order);
+            G1 Ppub = pfc.mult(base->P, s);
+
+            // 各分片互不依赖：节点表与群组表的每个分片作为一个并行任务，结果整片替换
+            const size_t shards = SnapshotMap<NodeRecord>::SHARDS;
+            vector<shared_ptr<SnapshotMap<NodeRecord>::Shard>> nodeShards(shards);
+            vector<shared_ptr<SnapshotMap<GroupRecord>::Shard>> groupShards(shards);
+            vector<vector<shared_ptr<GroupRecord>>> rekeyedGroups(shards);
+            parallelFor(2 * shards, 1, [&](size_t begin, size_t end)
+            {
+                PFC &workerPfc = threadPfc();
+                for (size_t i = begin; i < end && !token.stopRequested(); i++)
+                {
+                    if (i < shards)
+                    {
+                        nodeShards[i] = make_shared<SnapshotMap<NodeRecord>::Shard>(base->nodes.shard(i));
+                        for (auto &entry : *nodeShards[i])
+                        {
+                            entry.second = rekeyNode(workerPfc, entry.second, k);
+                        }
+                        continue;
+                    }
+
+                    size_t g = i - shards;
+                    groupShards[g] = make_shared<SnapshotMap<GroupRecord>::Shard>(base->groups.shard(g));
+                    for (auto &entry : *groupShards[g])
+                    {
+                        shared_ptr<GroupRecord> group = rekeyGroup(workerPfc, *entry.second, k);
+                        rekeyedGroups[g].push_back(group);
+                        entry.second = group;
+                    }
+                }
+            });
+
+            if (token.stopRequested())
+            {
+                status = token.stopReason();
+                return 0;
+            }
 
-            // 计算节点私钥 si = s*qi
-            G1 si = pfc.mult(qi, s);
+            lock_guard<mutex> lock(writerMtx);
+            shared_ptr<EngineState> next = beginWrite();
 
-            // 生成随机数xi (将在群组生成阶段使用)
-            Big xi;
-            pfc.random(xi);
-            while (xi == 0)
+            // 计算期间发布的写入(新注册的节点、新建或变更的群组)仍基于旧主密钥，在此补做轮换；
+            // 未被修改的分片直接整片替换
+            for (size_t i = 0; i < shards; i++)
             {
-                pfc.random(xi);
+                if (!next->nodes.sharesShard(base->nodes, i))
+                {
+                    nodeShards[i] = mergeRekeyed<NodeRecord>(next->nodes, base->nodes, i, *nodeShards[i],
+                                                             [&](const shared_ptr<const NodeRecord> &record)
+                                                             {
+                                                                 return rekeyNode(pfc, record, k);
+                                                             });
+                }
+                next->nodes.replaceShard(i, nodeShards[i]);
+
+                // 群组公钥已改变，版本号随之更新，使旧纪元的陷门记忆失效
+                for (const auto &group : rekeyedGroups[i])
+                {
+                    group->version = next->version;
+                }
+                if (!next->groups.sharesShard(base->groups, i))
+                {
+                    groupShards[i] = mergeRekeyed<GroupRecord>(next->groups, base->groups, i, *groupShards[i],
+                                                               [&](const shared_ptr<const GroupRecord> &record)
+                                                               {
+                                                                   shared_ptr<GroupRecord> group = rekeyGroup(pfc, *record, k);
+                                                                   group->version = next->version;
+                                                                   return shared_ptr<const GroupRecord>(group);
+                                                               });
+                }
+                next->groups.replaceShard(i, groupShards[i]);
             }
 
-            // 存储节点私钥和随机值
-            nodePrivateKeys[nodeId] = si;
-            nodeRandomValues[nodeId] = xi;
+            next->s = s;
+            next->Ppub = Ppub;
+            next->keyEpoch++;
+            publish(next);
 
-            // 计算私钥的哈希值作为字符串返回
-            pfc.start_hash();
-            pfc.add_to_hash(si);
-            Big si_hash = pfc.finish_hash_to_group();
+            // 热缓存中派生的节点密钥属于旧纪元
+            nodeKeyCache.clear();
 
-            // 将私钥哈希值转换为字符串
-            stringstream ss;
-            ss << si_hash;
-            string privateKeyStr = ss.str();
+            cout << "主密钥轮换完成，密钥纪元: " << next->keyEpoch << endl;
+            return next->keyEpoch;
+        }
+        catch (const exception &e)
+        {
+            cerr << "主密钥轮换失败: " << e.what() << endl;
+            return 0;
+        }
+    }
+
+    uint64_t currentKeyEpoch() const
+    {
+        return snapshot()->keyEpoch;
+    }
+
+    // 2. 节点注册 (NodeReg)
+    pair<string, string> nodeRegistration(const string &nodeId)
+    {
+        PFC &pfc = threadPfc();
+        shared_ptr<const EngineState> current = snapshot();
+
+        if (!current->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return make_pair("", "");
+        }
+
+        try
+        {
+            // 密钥提取只依赖系统参数，在写锁外完成
+            NodeKeyMaterial material;
+            extractNodeKey(pfc, nodeId, *current, current->derivedNodeKeys, material);
+
+            lock_guard<mutex> lock(writerMtx);
+            shared_ptr<EngineState> next = beginWrite();
+            // 提取期间主密钥已轮换时按新主密钥重新提取
+            if (next->keyEpoch != current->keyEpoch)
+            {
+                extractNodeKey(pfc, nodeId, *next, material.derived, material);
+            }
+            commitNodeKey(pfc, *next, nodeId, material);
+            publish(next);
 
-            return make_pair(nodeId, privateKeyStr);
+            return make_pair(nodeId, material.privateKeyStr);
         }
         catch (const exception &e)
         {
@@ -157,92 +389,193 @@ public:
         }
     }
 
-    // 3. 群组生成 (GroupGen)
-    string groupGeneration(const vector<string> &nodeIds)
+    // 2b. 批量节点注册 (NodeReg) - 并行提取密钥，一次性提交
+    vector<pair<string, string>> nodeRegistrationBatch(const vector<string> &nodeIds)
     {
-        lock_guard<mutex> lock(mtx);
+        vector<pair<string, string>> results(nodeIds.size(), make_pair(string(), string()));
 
-        if (!initialized)
+        shared_ptr<const EngineState> current = snapshot();
+        if (!current->initialized)
         {
             cerr << "错误: 系统未初始化" << endl;
-            return "";
+            return results;
         }
-
         try
         {
-            // 生成唯一的群组ID
-            string groupId = generateUniqueId();
+            // 批量注册属于后台任务，让出预留给交互请求的线程
+            ScopedTaskPriority priority(TaskPriority::Bulk);
+
+            vector<NodeKeyMaterial> materials(nodeIds.size());
+            vector<char> extracted(nodeIds.size(), 0);
 
-            // 构建完整群组ID (用于内部计算)
-            string fullGroupId = "";
-            for (const auto &nodeId : nodeIds)
+            parallelFor(nodeIds.size(), NODE_REGISTRATION_GRAIN, [&](size_t begin, size_t end)
             {
-                // 检查节点是否已注册
-                if (nodePrivateKeys.find(nodeId) == nodePrivateKeys.end())
+                PFC &pfc = threadPfc();
+                for (size_t i = begin; i < end; i++)
                 {
-                    cerr << "错误: 节点未注册: " << nodeId << endl;
-                    return "";
+                    if (nodeIds[i].empty())
+                    {
+                        continue;
+                    }
+                    extractNodeKey(pfc, nodeIds[i], *current, current->derivedNodeKeys, materials[i]);
+                    extracted[i] = 1;
+                }
+            });
+
+            // 全部结果写入同一个新版本，一次发布
+            lock_guard<mutex> lock(writerMtx);
+            shared_ptr<EngineState> next = beginWrite();
+
+            // 提取期间主密钥已轮换时按新主密钥重新提取(罕见，在写锁内完成以免再次错过轮换)
+            if (next->keyEpoch != current->keyEpoch)
+            {
+                parallelFor(nodeIds.size(), NODE_REGISTRATION_GRAIN, [&](size_t begin, size_t end)
+                {
+                    PFC &pfc = threadPfc();
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        if (extracted[i])
+                        {
+                            extractNodeKey(pfc, nodeIds[i], *next, materials[i].derived, materials[i]);
+                        }
+                    }
+                });
+            }
+            PFC &pfc = threadPfc();
+            for (size_t i = 0; i < nodeIds.size(); i++)
+            {
+                if (!extracted[i])
+                {
+                    cerr << "错误: 节点ID为空，跳过第" << i << "个节点" << endl;
+                    continue;
                 }
-                fullGroupId += nodeId;
+                commitNodeKey(pfc, *next, nodeIds[i], materials[i]);
+                results[i] = make_pair(nodeIds[i], materials[i].privateKeyStr);
             }
+            publish(next);
+        }
+        catch (const exception &e)
+        {
+            cerr << "批量节点注册失败: " << e.what() << endl;
+        }
+
+        return results;
+    }
+
+    // 3. 群组生成 (GroupGen) - 取消或超时后放弃整个群组，不写入部分结果
+    string groupGeneration(const vector<string> &nodeIds, const CancellationToken &token, BatchStatus &status,
+                           GroupLayout layout)
+    {
+        status = BatchStatus::Completed;
 
-            // 存储群组成员
-            groupMembers[groupId] = nodeIds;
+        if (nodeIds.empty())
+        {
+            cerr << "错误: 群组成员不能为空" << endl;
+            return "";
+        }
+
+        try
+        {
+            ScopedTaskPriority priority(TaskPriority::Bulk);
 
-            // 计算群公钥组件r = Σri, 其中ri = xi*P
-            G1 r;
-            bool firstNode = true;
-            for (const auto &nodeId : nodeIds)
+            for (int attempt = 0; attempt < GROUP_GENERATION_ATTEMPTS; attempt++)
             {
-                Big xi = nodeRandomValues[nodeId];
-                G1 ri = pfc.mult(P, xi);
+                shared_ptr<const EngineState> current = snapshot();
+                if (!current->initialized)
+                {
+                    cerr << "错误: 系统未初始化" << endl;
+                    return "";
+                }
 
-                if (firstNode)
+                // 从快照中取出成员的密钥材料，运算期间不持有任何锁
+                vector<shared_ptr<const NodeRecord>> records(nodeIds.size());
+                for (size_t i = 0; i < nodeIds.size(); i++)
                 {
-                    r = ri;
-                    firstNode = false;
+                    records[i] = current->nodes.find(nodeIds[i]);
+                    if (!records[i])
+                    {
+                        cerr << "错误: 节点未注册: " << nodeIds[i] << endl;
+                        return "";
+                    }
                 }
-                else
+
+                G1 r;
+                CompressedGT phi;
+                GroupTree::NodePtr tree;
+                vector<shared_ptr<const NodeRecord>> keys;
+                if (!resolveNodeKeys(*current, nodeIds, records, token, keys))
+                {
+                    status = token.stopReason();
+                    return "";
+                }
+                if (layout == GroupLayout::Hierarchical)
                 {
-                    r = r + ri;
+                    // 层次群组：各子树并行计算部分和，根节点即整体公钥
+                    tree = GroupTree::build(nodeIds, keys, threadPfc().order(), token);
+                    if (!tree)
+                    {
+                        status = token.stopReason();
+                        return "";
+                    }
+                    r = tree->r;
+                    phi = tree->phi;
+                }
+                else if (!computeGroupKeys(keys, token, r, phi))
+                {
+                    status = token.stopReason();
+                    return "";
                 }
-            }
 
-            // 计算群公钥组件Φ = e(Σqi, Ppub)
-            G1 q_sum;
-            firstNode = true;
-            for (const auto &nodeId : nodeIds)
-            {
-                if (nodePublicKeys.find(nodeId) == nodePublicKeys.end())
+                lock_guard<mutex> lock(writerMtx);
+                shared_ptr<EngineState> next = beginWrite();
+
+                // 运算期间有成员被重新注册或主密钥已轮换时结果已过期，基于新版本重算
+                bool stale = next->keyEpoch != current->keyEpoch;
+                for (size_t i = 0; i < nodeIds.size() && !stale; i++)
                 {
-                    // 如果找不到已存储的公钥，重新计算
-                    G1 qi;
-                    char idStr[256] = {0};
-                    strcpy(idStr, nodeId.c_str());
-                    pfc.hash_and_map(qi, idStr);
-                    nodePublicKeys[nodeId] = qi;
+                    stale = next->nodes.find(nodeIds[i]) != records[i];
                 }
+                if (stale)
+                {
+                    continue;
+                }
+
+                // 生成唯一的群组ID
+                string groupId = UniqueIdGenerator::instance().next().toString();
 
-                if (firstNode)
+                // 存储群组成员与公钥
+                shared_ptr<GroupRecord> group = make_shared<GroupRecord>();
+                if (!tree)
                 {
-                    q_sum = nodePublicKeys[nodeId];
-                    firstNode = false;
+                    group->members = nodeIds;
                 }
-                else
+                group->tree = tree;
+                group->r = r;
+                group->phi = phi;
+                group->version = next->version;
+                next->groups.set(groupId, group);
+
+                // 维护节点到群组的反向索引
+                for (const auto &nodeId : nodeIds)
                 {
-                    q_sum = q_sum + nodePublicKeys[nodeId];
+                    shared_ptr<set<string>> groups = make_shared<set<string>>();
+                    shared_ptr<const set<string>> existing = next->nodeGroups.find(nodeId);
+                    if (existing)
+                    {
+                        *groups = *existing;
+                    }
+                    groups->insert(groupId);
+                    next->nodeGroups.set(nodeId, groups);
                 }
-            }
 
-            // 计算双线性配对 Φ = e(q_sum, Ppub)
-            GT phi = pfc.pairing(q_sum, Ppub);
+                publish(next);
 
-            // 存储群组公钥
-            groupPublicKeysR[groupId] = r;
-            groupPublicKeysPhi[groupId] = phi;
+                // 返回群组ID
+                return groupId;
+            }
 
-            // 返回群组ID
-            return groupId;
+            cerr << "错误: 群组成员持续变更，群组生成未完成" << endl;
+            return "";
         }
         catch (const exception &e)
         {
@@ -254,9 +587,9 @@ public:
     // 4. 随机关键字生成 (KeywordGen)
     string generateKeyword()
     {
-        lock_guard<mutex> lock(mtx);
+        PFC &pfc = threadPfc();
 
-        if (!initialized)
+        if (!snapshot()->initialized)
         {
             cerr << "错误: 系统未初始化" << endl;
             return "";
@@ -267,7 +600,6 @@ public:
             // 生成随机关键字
             Big randomValue;
             pfc.random(randomValue);
-
             stringstream ss;
             ss << randomValue;
     return ss.str();
@@ -282,9 +614,10 @@ public:
     // 5. 消息封装 (Encapsulation) - 关键字加密
     string encapsulateKeyword(const string &keyword, const string &groupId)
     {
-        lock_guard<mutex> lock(mtx);
+        PFC &pfc = threadPfc();
+        shared_ptr<const EngineState> current = snapshot();
 
-        if (!initialized)
+        if (!current->initialized)
         {
             cerr << "错误: 系统未初始化" << endl;
             return "";
@@ -293,52 +626,32 @@ public:
         try
         {
             // 检查群组是否存在
-            if (groupPublicKeysR.find(groupId) == groupPublicKeysR.end() ||
-                groupPublicKeysPhi.find(groupId) == groupPublicKeysPhi.end())
+            shared_ptr<const GroupRecord> group = current->groups.find(groupId);
+            if (!group)
             {
                 cerr << "错误: 群组不存在: " << groupId << endl;
                 return "";
             }
 
-            // 获取群组公钥
-            G1 r = groupPublicKeysR[groupId];
-            GT phi = groupPublicKeysPhi[groupId];
-
             // 生成随机数y
             Big y;
             pfc.random(y);
 
             // 计算 X = y*P
-            G1 X = pfc.mult(P, y);
-
-            // 构建完整的GroupID||keyword
-            string fullGroupId = groupId + keyword;
-
-            // 计算 H2(GroupID||keyword)
-            G1 h2_value;
-            char gidKeyword[1024] = {0};
-            strcpy(gidKeyword, fullGroupId.c_str());
-            pfc.hash_and_map(h2_value, gidKeyword);
-
-            // 计算 e(H2(GroupID||keyword), r)
-            GT e_h2_r = pfc.pairing(h2_value, r);
-
-            // 计算 e(H2(GroupID||keyword), r) * phi
-            GT combined = e_h2_r * phi;
-
-            // 计算 Y = H3(e(H2(GroupID||keyword), r) * phi)^y
-            GT powered = pfc.power(combined, y);
-            Big Y = pfc.hash_to_aes_key(powered);
+            shared_ptr<EncRecord> record = make_shared<EncRecord>();
+            record->X = pfc.mult(current->P, y);
+            record->Y.push_back(keywordTag(pfc, groupId, *group, keyword, y));
 
             // 生成唯一ID
-            string encId = "enc_" + generateUniqueId();
+            UniqueId encUid = UniqueIdGenerator::instance().next();
+            string encId = ENC_ID_PREFIX + encUid.toString();
 
             // 将(X,Y)缓存起来供后续验证
-            encCache[encId] = make_pair(X, Y);
+            encCache.insert(encUid, record);
 
             // 序列化为JSON格式返回
             stringstream ss;
-            ss << Y;
+            ss << record->Y[0];
             string result = "{\"id\":\"" + encId + "\",";
             result += "\"groupId\":\"" + groupId + "\",";
             result += "\"keyword\":\"" + keyword + "\",";
@@ -353,159 +666,170 @@ public:
         }
     }
 
-    // 6. 授权测试 (AuthTest) - 生成陷门
-    string searchTokenGeneration(const string &keyword, const string &groupId)
+    // 5a. 多关键字消息封装 - 一条记录的所有关键字共享随机数y与X，每个关键字一个Y
+    string encapsulateKeywords(const vector<string> &keywords, const string &groupId)
     {
-        lock_guard<mutex> lock(mtx);
+        PFC &pfc = threadPfc();
+        shared_ptr<const EngineState> current = snapshot();
 
-        if (!initialized)
+        if (!current->initialized)
         {
             cerr << "错误: 系统未初始化" << endl;
             return "";
         }
 
+        if (keywords.empty())
+        {
+            cerr << "错误: 关键字不能为空" << endl;
+            return "";
+        }
+
         try
         {
-            // 检查群组是否存在
-            if (groupMembers.find(groupId) == groupMembers.end())
+            shared_ptr<const GroupRecord> group = current->groups.find(groupId);
+            if (!group)
             {
                 cerr << "错误: 群组不存在: " << groupId << endl;
                 return "";
             }
 
-            // 获取群组成员
-            const vector<string> &members = groupMembers[groupId];
-
-            // 构建完整的GroupID||keyword
-            string fullGroupId = groupId + keyword;
-
-            // 计算 H2(GroupID||keyword)
-            G1 h2_value;
-            char gidKeyword[1024] = {0};
-            strcpy(gidKeyword, fullGroupId.c_str());
-            pfc.hash_and_map(h2_value, gidKeyword);
+            // 整条记录只计算一次 X = y*P
+            Big y;
+            pfc.random(y);
+            shared_ptr<EncRecord> record = make_shared<EncRecord>();
+            record->X = pfc.mult(current->P, y);
+            record->Y.reserve(keywords.size());
+            for (const auto &keyword : keywords)
+            {
+                record->Y.push_back(keywordTag(pfc, groupId, *group, keyword, y));
+            }
 
-            // 计算陷门 T = Σ(si + xi*H2(GroupID||keyword))
-            G1 T;
-            bool firstNode = true;
+            UniqueId encUid = UniqueIdGenerator::instance().next();
+            string encId = ENC_ID_PREFIX + encUid.toString();
+            encCache.insert(encUid, record);
 
-            for (const auto &nodeId : members)
+            // 序列化为JSON格式返回，keywords与y一一对应
+            string keywordList;
+            string tagList;
+            for (size_t i = 0; i < keywords.size(); i++)
             {
-                // 检查节点是否已注册
-                if (nodePrivateKeys.find(nodeId) == nodePrivateKeys.end() ||
-                    nodeRandomValues.find(nodeId) == nodeRandomValues.end())
-                {
-                    cerr << "错误: 节点未注册或缺少随机值: " << nodeId << endl;
-                    continue;
-                }
+                stringstream ss;
+                ss << record->Y[i];
+                keywordList += (i > 0 ? ",\"" : "\"") + keywords[i] + "\"";
+                tagList += (i > 0 ? ",\"" : "\"") + ss.str() + "\"";
+            }
+            string result = "{\"id\":\"" + encId + "\",";
+            result += "\"groupId\":\"" + groupId + "\",";
+            result += "\"keywords\":[" + keywordList + "],";
+            result += "\"y\":[" + tagList + "]}";
 
-                // 获取节点私钥和随机值
-                G1 si = nodePrivateKeys[nodeId];
-                Big xi = nodeRandomValues[nodeId];
+            return result;
+        }
+        catch (const exception &e)
+        {
+            cerr << "多关键字封装失败: " << e.what() << endl;
+            return "";
+        }
+    }
 
-                // 计算 xi*H2(GroupID||keyword)
-                G1 xi_h2 = pfc.mult(h2_value, xi);
+    // 5b. 批量消息封装 - 以批量优先级并行封装多个关键字，不占用交互请求的预留线程
+    EncapsulationBatchResult encapsulateKeywordBatch(const vector<string> &keywords, const string &groupId,
+                                                     const CancellationToken &token)
+    {
+        EncapsulationBatchResult result;
+        result.encapsulations.resize(keywords.size());
+        result.evaluated.assign(keywords.size(), false);
+        result.status = BatchStatus::Completed;
 
-                // 计算 wi = si + xi*H2(GroupID||keyword)
-                G1 wi = si;
-                wi = wi + xi_h2;
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return result;
+        }
 
-                // 累加到陷门T
-                if (firstNode)
-                {
-                    T = wi;
-                    firstNode = false;
-                }
-                else
+        try
+        {
+            vector<char> evaluated(keywords.size(), 0);
+            ScopedTaskPriority priority(TaskPriority::Bulk);
+            parallelFor(keywords.size(), ENCAPSULATION_BATCH_GRAIN, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end && !token.stopRequested(); i++)
                 {
-                    T = T + wi;
+                    result.encapsulations[i] = encapsulateKeyword(keywords[i], groupId);
+                    evaluated[i] = 1;
                 }
-            }
+            });
 
-            // 生成唯一ID
-            string trapdoorId = "td_" + generateUniqueId();
-
-            // 缓存陷门T供后续验证
-            trapdoorCache[trapdoorId] = T;
-
-            // 返回格式: "trapdoorId|groupId|keyword"
-            return trapdoorId + "|" + groupId + "|" + keyword;
+            result.status = collectEvaluated(evaluated, result.evaluated, token);
         }
         catch (const exception &e)
         {
-            cerr << "生成陷门失败: " << e.what() << endl;
-            return "";
+            cerr << "批量关键字封装失败: " << e.what() << endl;
         }
+
+        return result;
     }
 
-    // 7. 资源分配 (ResourceAllocation) - 关键字匹配检查
-    bool verifyKeywordMatch(const string &trapdoor, const string &encryptedMetadata)
+    // 5c. 群组词表预计算 - 在后台为已知的关键词求出H2(GroupID||keyword)，可选地求出封装用的GT底数并建表，
+    // 使这些关键词首次出现在交互请求中时即命中缓存。结果放入有界的LRU缓存，超出容量时最久未用的被淘汰
+    size_t registerGroupVocabulary(const string &groupId, const vector<string> &keywords, bool precomputeBases,
+                                   const CancellationToken &token, BatchStatus &status)
     {
-        lock_guard<mutex> lock(mtx);
+        status = BatchStatus::Completed;
+        shared_ptr<const EngineState> current = snapshot();
 
-        if (!initialized)
+        if (!current->initialized)
         {
             cerr << "错误: 系统未初始化" << endl;
-            return false;
+            return 0;
         }
 
         try
         {
-            // 解析陷门
-            string trapdoorId, groupId, keyword;
-            if (!parseTrapdoor(trapdoor, trapdoorId, groupId, keyword))
-            {
-                cerr << "错误: 无效的陷门格式" << endl;
-                return false;
-            }
-
-            // 解析加密元数据
-            string encId;
-            if (!parseEncryptedMetadata(encryptedMetadata, encId))
+            shared_ptr<const GroupRecord> group = current->groups.find(groupId);
+            if (!group)
             {
-                cerr << "错误: 无效的加密元数据格式" << endl;
-                return false;
+                cerr << "错误: 群组不存在: " << groupId << endl;
+                return 0;
             }
 
-            // 检查缓存中是否存在对应的T和(X,Y)
-            if (trapdoorCache.find(trapdoorId) == trapdoorCache.end() ||
-                encCache.find(encId) == encCache.end())
+            vector<char> prepared(keywords.size(), 0);
+            ScopedTaskPriority priority(TaskPriority::Bulk);
+            parallelFor(keywords.size(), VOCABULARY_GRAIN, [&](size_t begin, size_t end)
             {
-                cerr << "错误: 找不到对应的陷门或加密数据" << endl;
-                return false;
-            }
-
-            // 获取T和(X,Y)
-            G1 T = trapdoorCache[trapdoorId];
-            G1 X = encCache[encId].first;
-            Big Y = encCache[encId].second;
-
-            // 计算配对 e(T, X)
-            GT pairingResult = pfc.pairing(T, X);
-
-            // 计算 H3(e(T, X))
-            Big hashResult = pfc.hash_to_aes_key(pairingResult);
+                PFC &workerPfc = threadPfc();
+                for (size_t i = begin; i < end && !token.stopRequested(); i++)
+                {
+                    if (precomputeBases)
+                    {
+                        keywordBase(workerPfc, groupId, *group, keywords[i], true);
+                    }
+                    else
+                    {
+                        keywordPoint(workerPfc, groupId, keywords[i]);
+                    }
+                    prepared[i] = 1;
+                }
+            });
 
-            // 验证 Y == H3(e(T, X))
-            return (Y == hashResult);
+            vector<bool> evaluated(keywords.size(), false);
+            status = collectEvaluated(prepared, evaluated, token);
+            return static_cast<size_t>(count(evaluated.begin(), evaluated.end(), true));
         }
         catch (const exception &e)
         {
-            cerr << "验证关键字匹配失败: " << e.what() << endl;
-            return false;
+            cerr << "群组词表预计算失败: " << e.what() << endl;
+            return 0;
         }
     }
 
-    // 基于关键字匹配结果分配资源
-    string allocateResourcesAccordingToKeywords(
-        const string &trapdoor,
-        const vector<string> &encryptedMetadataList,
-        const vector<string> &edgeNodeIds)
+    // 6. 授权测试 (AuthTest) - 生成陷门
+    string searchTokenGeneration(const string &keyword, const string &groupId)
     {
+        PFC &pfc = threadPfc();
+        shared_ptr<const EngineState> current = snapshot();
 
-        lock_guard<mutex> lock(mtx);
-
-        if (!initialized)
+        if (!current->initialized)
         {
             cerr << "错误: 系统未初始化" << endl;
             return "";
@@ -513,84 +837,1554 @@ public:
 
         try
         {
-            // 解析陷门
-            string trapdoorId, groupId, keyword;
-            if (!parseTrapdoor(trapdoor, trapdoorId, groupId, keyword))
+            // 检查群组是否存在
+            shared_ptr<const GroupRecord> group = current->groups.find(groupId);
+            if (!group)
             {
-                cerr << "错误: 无效的陷门格式" << endl;
+                cerr << "错误: 群组不存在: " << groupId << endl;
                 return "";
             }
 
-            // 遍历所有加密元数据，找出匹配的
-            vector<int> matchedIndices;
-            for (size_t i = 0; i < encryptedMetadataList.size(); i++)
+            // 同一(群组, 关键词)的陷门已生成且群组未变更时直接复用
+            string memoKey = groupId + "|" + keyword;
+            TrapdoorMemoEntry memo;
+            if (trapdoorMemo.find(memoKey, memo) && memo.groupVersion == group->version &&
+                trapdoorCache.contains(memo.trapdoorUid))
             {
-                if (verifyKeywordMatch(trapdoor, encryptedMetadataList[i]))
-                {
-                    matchedIndices.push_back(i);
-                }
+                return TRAPDOOR_ID_PREFIX + memo.trapdoorUid.toString() + "|" + groupId + "|" + keyword;
             }
 
-            // 如果没有匹配，返回空
-            if (matchedIndices.empty())
+            // 获取群组成员
+            const vector<string> &members = group->members;
+
+            // 计算 H2(GroupID||keyword)，已登记词表的关键词已预先求出
+            shared_ptr<const G1> h2Point = keywordPoint(pfc, groupId, keyword);
+            const G1 &h2_value = *h2Point;
+
+            // 计算陷门 T = Σ(si + xi*H2(GroupID||keyword)) = Σsi + Σ(xi*H2)
+            // 层次群组由根节点缓存的部分和直接求出：Σsi = s*Σqi，Σ(xi*H2) = (Σxi)*H2，与成员数无关
+            if (group->tree)
             {
-                return "";
+                G1 siTotal = pfc.mult(group->tree->qSum, current->s);
+                G1 xiTotal = pfc.mult(h2_value, group->tree->xiSum);
+                return issueTrapdoor(make_shared<G1>(siTotal + xiTotal), memoKey, group->version, groupId, keyword);
             }
 
-            // 简单分配策略：选择第一个匹配的元数据对应的边缘节点
-            int selectedIndex = matchedIndices[0];
-            if (selectedIndex < edgeNodeIds.size())
+            PointAccumulator siSum;
+            Big order = pfc.order();
+            Big xiTotal = 0;
+            bool anyMember = false;
+
+            for (const auto &nodeId : members)
             {
-                return edgeNodeIds[selectedIndex];
+                // 检查节点是否已注册(派生密钥模式下注册的节点在此重新计算密钥材料)
+                shared_ptr<const NodeRecord> node = current->nodes.find(nodeId);
+                if (node)
+                {
+                    node = nodeKeys(pfc, *current, nodeId, node);
+                }
+                if (!node)
+                {
+                    cerr << "错误: 节点未注册或缺少随机值: " << nodeId << endl;
+                    continue;
+                }
+
+                // 在射影坐标下累加节点私钥si
+                siSum.add(node->si);
+
+                xiTotal = (xiTotal + node->xi) % order;
+                anyMember = true;
             }
 
-            return "";
+            // 各项底点都是H2，Σ(xi*H2) = (Σxi mod n)*H2，只需一次标量乘法
+            if (anyMember)
+            {
+                siSum.add(pfc.mult(h2_value, xiTotal));
+            }
+            shared_ptr<const G1> T = make_shared<G1>(siSum.toAffine());
+            return issueTrapdoor(T, memoKey, group->version, groupId, keyword);
         }
         catch (const exception &e)
         {
-            cerr << "资源分配失败: " << e.what() << endl;
+            cerr << "生成陷门失败: " << e.what() << endl;
             return "";
         }
     }
 
-    // 辅助方法：生成唯一ID
-    string generateUniqueId()
+    // 3b. 群组成员增删 - 按成员分量增量更新群组公钥，层次群组只复制成员所在的根到叶路径
+    bool updateGroupMembers(const string &groupId, const vector<string> &nodeIds, bool add)
     {
-        time_t now = time(nullptr);
-        string idStr = to_string(now) + to_string(rand());
-        return idStr;
-    }
+        PFC &pfc = threadPfc();
 
-    // 辅助方法：解析陷门
-    bool parseTrapdoor(const string &trapdoor, string &trapdoorId, string &groupId, string &keyword)
-    {
-        size_t pos1 = trapdoor.find('|');
-        if (pos1 == string::npos)
+        try
         {
-            return false;
-        }
+            for (int attempt = 0; attempt < GROUP_GENERATION_ATTEMPTS; attempt++)
+            {
+                shared_ptr<const EngineState> current = snapshot();
+                if (!current->initialized)
+                {
+                    cerr << "错误: 系统未初始化" << endl;
+                    return false;
+                }
 
-        size_t pos2 = trapdoor.find('|', pos1 + 1);
-        if (pos2 == string::npos)
-        {
-            return false;
-        }
+                // 在写锁外取得变动成员的密钥材料(派生密钥模式下可能需要重算)
+                vector<shared_ptr<const NodeRecord>> records(nodeIds.size());
+                for (size_t i = 0; i < nodeIds.size(); i++)
+                {
+                    records[i] = current->nodes.find(nodeIds[i]);
+                    if (!records[i])
+                    {
+                        cerr << "错误: 节点未注册: " << nodeIds[i] << endl;
+                        return false;
+                    }
+                }
+                vector<shared_ptr<const NodeRecord>> keys;
+                resolveNodeKeys(*current, nodeIds, records, CancellationToken::none(), keys);
 
-        trapdoorId = trapdoor.substr(0, pos1);
-        groupId = trapdoor.substr(pos1 + 1, pos2 - pos1 - 1);
-        keyword = trapdoor.substr(pos2 + 1);
-        return true;
-    }
+                lock_guard<mutex> lock(writerMtx);
+                shared_ptr<EngineState> next = beginWrite();
 
-    // 辅助方法：解析加密元数据
-    bool parseEncryptedMetadata(const string &metadata, string &encId)
-    {
-        // 假设metadata是JSON格式，解析出id字段
-        size_t idPos = metadata.find("\"id\"");
-        if (idPos == string::npos)
-        {
-            return false;
-        }
+                bool stale = next->keyEpoch != current->keyEpoch;
+                for (size_t i = 0; i < nodeIds.size() && !stale; i++)
+                {
+                    stale = next->nodes.find(nodeIds[i]) != records[i];
+                }
+                if (stale)
+                {
+                    continue;
+                }
+
+                shared_ptr<const GroupRecord> group = next->groups.find(groupId);
+                if (!group)
+                {
+                    cerr << "错误: 群组不存在: " << groupId << endl;
+                    return false;
+                }
+
+                shared_ptr<GroupRecord> updated = make_shared<GroupRecord>(*group);
+                vector<string> changed;
+                if (!applyMembership(pfc, *next, groupId, nodeIds, keys, add, *updated, changed))
+                {
+                    return false;
+                }
+                if (changed.empty())
+                {
+                    return true;
+                }
+
+                // 群组公钥改变，版本号随之更新，该群组的陷门记忆失效
+                updated->version = next->version;
+                next->groups.set(groupId, updated);
+                for (const auto &nodeId : changed)
+                {
+                    shared_ptr<set<string>> groups = make_shared<set<string>>();
+                    shared_ptr<const set<string>> existing = next->nodeGroups.find(nodeId);
+                    if (existing)
+                    {
+                        *groups = *existing;
+                    }
+                    if (add)
+                    {
+                        groups->insert(groupId);
+                    }
+                    else
+                    {
+                        groups->erase(groupId);
+                    }
+                    next->nodeGroups.set(nodeId, groups);
+                }
+
+                publish(next);
+                return true;
+            }
+
+            cerr << "错误: 成员密钥在更新期间反复变化，放弃更新群组: " << groupId << endl;
+            return false;
+        }
+        catch (const exception &e)
+        {
+            cerr << "更新群组成员失败: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    // 7. 资源分配 (ResourceAllocation) - 关键字匹配检查
+    bool verifyKeywordMatch(const string &trapdoor, const string &encryptedMetadata)
+    {
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return false;
+        }
+
+        try
+        {
+            // 解析陷门
+            UniqueId trapdoorUid;
+            if (!resolveTrapdoorId(trapdoor, trapdoorUid))
+            {
+                cerr << "错误: 无效的陷门格式" << endl;
+                return false;
+            }
+
+            // 解析加密元数据
+            UniqueId encUid;
+            if (!resolveEncId(encryptedMetadata, encUid))
+            {
+                cerr << "错误: 无效的加密元数据格式" << endl;
+                return false;
+            }
+
+            return matchCachedIds(trapdoorUid, encUid);
+        }
+        catch (const exception &e)
+        {
+            cerr << "验证关键字匹配失败: " << e.what() << endl;
+            return false;
+        }
+    }
+
+    // 7b. 批量关键字匹配检查 - 合并多条独立的验证请求并行执行
+    VerifyBatchResult verifyKeywordMatchBatch(const vector<string> &trapdoors, const vector<string> &encryptedMetadataList,
+                                              const CancellationToken &token)
+    {
+        VerifyBatchResult result;
+        result.matched.assign(trapdoors.size(), false);
+        result.evaluated.assign(trapdoors.size(), false);
+        result.status = BatchStatus::Completed;
+
+        if (trapdoors.size() != encryptedMetadataList.size())
+        {
+            cerr << "错误: 陷门与加密元数据数量不一致" << endl;
+            return result;
+        }
+
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return result;
+        }
+
+        try
+        {
+            // vector<bool>按位存储，并行写入时先写入逐字节的数组
+            vector<char> matched(trapdoors.size(), 0);
+            vector<char> evaluated(trapdoors.size(), 0);
+            parallelFor(trapdoors.size(), VERIFY_BATCH_GRAIN, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end && !token.stopRequested(); i++)
+                {
+                    evaluated[i] = 1;
+                    UniqueId trapdoorUid, encUid;
+                    if (!resolveTrapdoorId(trapdoors[i], trapdoorUid))
+                    {
+                        cerr << "错误: 无效的陷门格式" << endl;
+                        continue;
+                    }
+                    if (!resolveEncId(encryptedMetadataList[i], encUid))
+                    {
+                        cerr << "错误: 无效的加密元数据格式" << endl;
+                        continue;
+                    }
+                    matched[i] = matchCachedIds(trapdoorUid, encUid) ? 1 : 0;
+                }
+            });
+
+            for (size_t i = 0; i < matched.size(); i++)
+            {
+                result.matched[i] = matched[i] != 0;
+            }
+            result.status = collectEvaluated(evaluated, result.evaluated, token);
+        }
+        catch (const exception &e)
+        {
+            cerr << "批量验证关键字匹配失败: " << e.what() << endl;
+        }
+
+        return result;
+    }
+
+    // 基于关键字匹配结果分配资源
+    AllocationResult allocateResourcesAccordingToKeywords(
+        const string &trapdoor,
+        const vector<string> &encryptedMetadataList,
+        const vector<string> &edgeNodeIds,
+        const CancellationToken &token,
+        double demand)
+    {
+        AllocationResult result;
+        result.evaluated = 0;
+        result.status = BatchStatus::Completed;
+
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return result;
+        }
+
+        try
+        {
+            // 解析陷门(只解析一次)
+            UniqueId trapdoorUid;
+            if (!resolveTrapdoorId(trapdoor, trapdoorUid))
+            {
+                cerr << "错误: 无效的陷门格式" << endl;
+                return result;
+            }
+
+            // 各加密元数据的匹配检查互不依赖，提交到调度器并行执行
+            vector<char> matched(encryptedMetadataList.size(), 0);
+            atomic<size_t> evaluated(0);
+            parallelFor(encryptedMetadataList.size(), ALLOCATION_MATCH_GRAIN, [&](size_t begin, size_t end)
+            {
+                for (size_t i = begin; i < end && !token.stopRequested(); i++)
+                {
+                    evaluated++;
+                    UniqueId encUid;
+                    if (!resolveEncId(encryptedMetadataList[i], encUid))
+                    {
+                        cerr << "错误: 无效的加密元数据格式" << endl;
+                        continue;
+                    }
+                    matched[i] = matchCachedIds(trapdoorUid, encUid) ? 1 : 0;
+                }
+            });
+
+            result.evaluated = evaluated.load();
+            if (result.evaluated < encryptedMetadataList.size())
+            {
+                result.status = token.stopReason();
+            }
+
+            // 按原顺序收集匹配的元数据对应的边缘节点
+            vector<string> candidates;
+            for (size_t i = 0; i < matched.size() && i < edgeNodeIds.size(); i++)
+            {
+                if (matched[i])
+                {
+                    candidates.push_back(edgeNodeIds[i]);
+                }
+            }
+
+            // 由当前分配策略在候选节点中选择，没有匹配或没有可用节点时返回空
+            size_t selected = allocationPolicy.select(candidates, demand);
+            if (selected != AllocationPolicyEngine::NPOS)
+            {
+                result.nodeId = candidates[selected];
+            }
+
+            return result;
+        }
+        catch (const exception &e)
+        {
+            cerr << "资源分配失败: " << e.what() << endl;
+            return result;
+        }
+    }
+
+    // 按当前分配策略返回排名前k的匹配节点，扫描时每块维护有界堆，最后合并
+    RankedAllocationResult allocateTopK(
+        const string &trapdoor,
+        const vector<string> &encryptedMetadataList,
+        const vector<string> &edgeNodeIds,
+        size_t k,
+        const CancellationToken &token,
+        double demand)
+    {
+        RankedAllocationResult result;
+        result.evaluated = 0;
+        result.status = BatchStatus::Completed;
+
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return result;
+        }
+
+        UniqueId trapdoorUid;
+        if (!resolveTrapdoorId(trapdoor, trapdoorUid))
+        {
+            cerr << "错误: 无效的陷门格式" << endl;
+            return result;
+        }
+
+        try
+        {
+            // 扫描前一次性取得各节点的排序键，扫描期间不访问策略引擎的锁
+            AllocationRanking ranking = allocationPolicy.rank(edgeNodeIds, demand);
+            size_t count = min(encryptedMetadataList.size(), edgeNodeIds.size());
+
+            TopKCollector best(k);
+            mutex bestMtx;
+            atomic<size_t> evaluated(0);
+            parallelFor(count, ALLOCATION_MATCH_GRAIN, [&](size_t begin, size_t end)
+            {
+                TopKCollector local(k);
+                for (size_t i = begin; i < end && !token.stopRequested(); i++)
+                {
+                    evaluated++;
+                    UniqueId encUid;
+                    if (!resolveEncId(encryptedMetadataList[i], encUid))
+                    {
+                        cerr << "错误: 无效的加密元数据格式" << endl;
+                        continue;
+                    }
+                    size_t slot = ranking.slotOf[i];
+                    if (matchCachedIds(trapdoorUid, encUid))
+                    {
+                        local.offer(ranking.keys[slot], slot, i);
+                    }
+                }
+                lock_guard<mutex> lock(bestMtx);
+                best.merge(local);
+            });
+
+            result.evaluated = evaluated.load();
+            if (result.evaluated < count)
+            {
+                result.status = token.stopReason();
+            }
+
+            for (const TopKCollector::Entry &entry : best.sorted())
+            {
+                result.nodeIds.push_back(ranking.slotNodes[entry.slot]);
+            }
+
+            // 与单节点分配一致，只为排名第一的节点记入需求
+            if (!result.nodeIds.empty())
+            {
+                allocationPolicy.charge(result.nodeIds[0], demand);
+            }
+        }
+        catch (const exception &e)
+        {
+            cerr << "资源分配失败: " << e.what() << endl;
+        }
+
+        return result;
+    }
+
+    // 多请求批量分配 - 将陷门×加密元数据矩阵分块，块内陷门共享配对预计算，每条记录只解码一次
+    BatchAllocationResult allocateBatch(
+        const vector<string> &trapdoors,
+        const vector<string> &encryptedMetadataList,
+        const vector<string> &edgeNodeIds,
+        const CancellationToken &token,
+        double demand)
+    {
+        BatchAllocationResult result;
+        result.nodeIds.resize(trapdoors.size());
+        result.complete.assign(trapdoors.size(), false);
+        result.status = BatchStatus::Completed;
+
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return result;
+        }
+
+        try
+        {
+            // 解析全部陷门与加密元数据，整轮只解析一次
+            size_t rows = trapdoors.size();
+            size_t cols = min(encryptedMetadataList.size(), edgeNodeIds.size());
+            vector<UniqueId> trapdoorUids(rows);
+            vector<shared_ptr<const G1>> trapdoorPoints(rows);
+            for (size_t t = 0; t < rows; t++)
+            {
+                if (!resolveTrapdoorId(trapdoors[t], trapdoorUids[t]) || !trapdoorCache.find(trapdoorUids[t], trapdoorPoints[t]))
+                {
+                    cerr << "错误: 无效的陷门格式" << endl;
+                }
+            }
+            vector<UniqueId> encUids(cols);
+            vector<shared_ptr<const EncRecord>> records(cols);
+            parallelFor(cols, BATCH_ALLOCATION_RECORD_TILE, [&](size_t begin, size_t end)
+            {
+                for (size_t r = begin; r < end; r++)
+                {
+                    if (!resolveEncId(encryptedMetadataList[r], encUids[r]) || !encCache.find(encUids[r], records[r]))
+                    {
+                        cerr << "错误: 无效的加密元数据格式" << endl;
+                    }
+                }
+            });
+
+            // 按(陷门块, 记录块)划分任务；块内以记录为外层循环，X与块内陷门的预计算表保持在缓存中
+            vector<char> matched(rows * cols, 0);
+            vector<char> evaluated(rows * cols, 0);
+            size_t rowTiles = (rows + BATCH_ALLOCATION_TRAPDOOR_TILE - 1) / BATCH_ALLOCATION_TRAPDOOR_TILE;
+            size_t colTiles = (cols + BATCH_ALLOCATION_RECORD_TILE - 1) / BATCH_ALLOCATION_RECORD_TILE;
+            parallelFor(rowTiles * colTiles, 1, [&](size_t tileBegin, size_t tileEnd)
+            {
+                PFC &workerPfc = threadPfc();
+                for (size_t tile = tileBegin; tile < tileEnd && !token.stopRequested(); tile++)
+                {
+                    size_t rowBegin = (tile / colTiles) * BATCH_ALLOCATION_TRAPDOOR_TILE;
+                    size_t rowEnd = min(rows, rowBegin + BATCH_ALLOCATION_TRAPDOOR_TILE);
+                    size_t colBegin = (tile % colTiles) * BATCH_ALLOCATION_RECORD_TILE;
+                    size_t colEnd = min(cols, colBegin + BATCH_ALLOCATION_RECORD_TILE);
+
+                    // 块内陷门的预计算副本在首次需要配对时才建立(结果都已缓存时不必预计算)
+                    vector<unique_ptr<G1>> prepared(rowEnd - rowBegin);
+                    for (size_t r = colBegin; r < colEnd && !token.stopRequested(); r++)
+                    {
+                        for (size_t t = rowBegin; t < rowEnd; t++)
+                        {
+                            size_t cell = t * cols + r;
+                            evaluated[cell] = 1;
+                            if (!trapdoorPoints[t] || !records[r])
+                            {
+                                continue;
+                            }
+
+                            bool isMatch = false;
+                            if (!matchCache.lookup(trapdoorUids[t], encUids[r], isMatch))
+                            {
+                                unique_ptr<G1> &point = prepared[t - rowBegin];
+                                if (!point)
+                                {
+                                    point.reset(new G1(*trapdoorPoints[t]));
+                                    workerPfc.precomp_for_pairing(*point);
+                                }
+                                isMatch = evaluateMatch(workerPfc, trapdoorUids[t], *point, encUids[r], *records[r]);
+                            }
+                            matched[cell] = isMatch ? 1 : 0;
+                        }
+                    }
+                }
+            });
+
+            // 按请求顺序依次在各自的匹配节点中选择，前面的分配计入负载后再服务后面的请求
+            for (size_t t = 0; t < rows; t++)
+            {
+                vector<string> candidates;
+                bool complete = true;
+                for (size_t r = 0; r < cols; r++)
+                {
+                    complete = complete && evaluated[t * cols + r];
+                    if (matched[t * cols + r])
+                    {
+                        candidates.push_back(edgeNodeIds[r]);
+                    }
+                }
+                result.complete[t] = complete;
+                if (!complete)
+                {
+                    result.status = token.stopReason();
+                }
+
+                size_t selected = allocationPolicy.select(candidates, demand);
+                if (selected != AllocationPolicyEngine::NPOS)
+                {
+                    result.nodeIds[t] = candidates[selected];
+                }
+            }
+        }
+        catch (const exception &e)
+        {
+            cerr << "批量资源分配失败: " << e.what() << endl;
+        }
+
+        return result;
+    }
+
+    // 多关键词布尔查询 - 逐条记录短路求值，按观测到的匹配率安排陷门的求值顺序
+    QueryMatchResult matchKeywordQuery(
+        const KeywordQuery &query,
+        const vector<string> &trapdoors,
+        const vector<string> &encryptedMetadataList,
+        const CancellationToken &token)
+    {
+        QueryMatchResult result;
+        result.matched.assign(encryptedMetadataList.size(), false);
+        result.evaluated.assign(encryptedMetadataList.size(), false);
+        result.pairings = 0;
+        result.status = BatchStatus::Completed;
+
+        try
+        {
+            vector<char> matched(encryptedMetadataList.size(), 0);
+            vector<char> evaluated(encryptedMetadataList.size(), 0);
+            if (!scanKeywordQuery(query, trapdoors, encryptedMetadataList, token, matched, evaluated, result.pairings))
+            {
+                return result;
+            }
+
+            for (size_t i = 0; i < matched.size(); i++)
+            {
+                result.matched[i] = matched[i] != 0;
+            }
+            result.status = collectEvaluated(evaluated, result.evaluated, token);
+        }
+        catch (const exception &e)
+        {
+            cerr << "多关键词查询失败: " << e.what() << endl;
+        }
+
+        return result;
+    }
+
+    // 按多关键词布尔查询分配资源
+    AllocationResult allocateByKeywordQuery(
+        const KeywordQuery &query,
+        const vector<string> &trapdoors,
+        const vector<string> &encryptedMetadataList,
+        const vector<string> &edgeNodeIds,
+        const CancellationToken &token,
+        double demand)
+    {
+        AllocationResult result;
+        result.evaluated = 0;
+        result.status = BatchStatus::Completed;
+
+        try
+        {
+            size_t count = min(encryptedMetadataList.size(), edgeNodeIds.size());
+            vector<char> matched(count, 0);
+            vector<char> evaluated(count, 0);
+            size_t pairings = 0;
+            if (!scanKeywordQuery(query, trapdoors, encryptedMetadataList, token, matched, evaluated, pairings))
+            {
+                return result;
+            }
+
+            vector<string> candidates;
+            for (size_t i = 0; i < count; i++)
+            {
+                result.evaluated += evaluated[i] ? 1 : 0;
+                if (matched[i])
+                {
+                    candidates.push_back(edgeNodeIds[i]);
+                }
+            }
+            if (result.evaluated < count)
+            {
+                result.status = token.stopReason();
+            }
+
+            size_t selected = allocationPolicy.select(candidates, demand);
+            if (selected != AllocationPolicyEngine::NPOS)
+            {
+                result.nodeId = candidates[selected];
+            }
+        }
+        catch (const exception &e)
+        {
+            cerr << "资源分配失败: " << e.what() << endl;
+        }
+
+        return result;
+    }
+
+    // 流式关键字匹配 - 每块检查完成后立即回调该块中匹配的下标
+    MatchScanResult streamKeywordMatches(
+        const string &trapdoor,
+        const vector<string> &encryptedMetadataList,
+        const MatchSink &sink,
+        const CancellationToken &token)
+    {
+        MatchScanResult result;
+        result.evaluated = 0;
+        result.matched = 0;
+        result.status = BatchStatus::Completed;
+
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return result;
+        }
+
+        UniqueId trapdoorUid;
+        if (!resolveTrapdoorId(trapdoor, trapdoorUid))
+        {
+            cerr << "错误: 无效的陷门格式" << endl;
+            return result;
+        }
+
+        // 按块划分，每轮在工作线程上并行检查一个窗口内的块，各块的匹配结果只写入本轮的缓冲；
+        // 一轮结束后在调用线程上按块顺序回调。回调阻塞(背压)时只有调用线程等待，工作线程已交还调度器，
+        // 不会因消费者慢而占住其他批量或交互请求的线程
+        size_t chunkCount = (encryptedMetadataList.size() + STREAM_MATCH_GRAIN - 1) / STREAM_MATCH_GRAIN;
+        size_t window = (TaskScheduler::instance().workerCount() + 1) * STREAM_MATCH_WINDOW_PER_THREAD;
+        atomic<size_t> evaluated(0);
+        for (size_t windowBegin = 0; windowBegin < chunkCount && !token.stopRequested(); windowBegin += window)
+        {
+            size_t windowEnd = min(chunkCount, windowBegin + window);
+            vector<vector<size_t>> chunkMatches(windowEnd - windowBegin);
+            parallelFor(windowEnd - windowBegin, 1, [&](size_t chunkBegin, size_t chunkEnd)
+            {
+                for (size_t c = chunkBegin; c < chunkEnd && !token.stopRequested(); c++)
+                {
+                    size_t begin = (windowBegin + c) * STREAM_MATCH_GRAIN;
+                    size_t end = min(encryptedMetadataList.size(), begin + STREAM_MATCH_GRAIN);
+                    for (size_t i = begin; i < end && !token.stopRequested(); i++)
+                    {
+                        evaluated++;
+                        UniqueId encUid;
+                        if (!resolveEncId(encryptedMetadataList[i], encUid))
+                        {
+                            cerr << "错误: 无效的加密元数据格式" << endl;
+                            continue;
+                        }
+                        if (matchCachedIds(trapdoorUid, encUid))
+                        {
+                            chunkMatches[c].push_back(i);
+                        }
+                    }
+                }
+            });
+
+            // 只统计实际交给回调的匹配，取消后不再回调
+            for (const auto &matched : chunkMatches)
+            {
+                if (token.stopRequested())
+                {
+                    break;
+                }
+                if (!matched.empty())
+                {
+                    sink(matched);
+                    result.matched += matched.size();
+                }
+            }
+        }
+
+        result.evaluated = evaluated.load();
+        if (result.evaluated < encryptedMetadataList.size())
+        {
+            result.status = token.stopReason();
+        }
+        return result;
+    }
+
+    // 释放陷门，同时清除其匹配结果缓存
+    bool releaseTrapdoor(const string &trapdoor)
+    {
+        UniqueId trapdoorUid;
+        if (!resolveTrapdoorId(trapdoor, trapdoorUid))
+        {
+            cerr << "错误: 无效的陷门格式" << endl;
+            return false;
+        }
+
+        bool erased = trapdoorCache.erase(trapdoorUid);
+        matchCache.eraseTrapdoor(trapdoorUid);
+        return erased;
+    }
+
+    // 释放封装数据，同时清除其匹配结果缓存
+    bool releaseEncapsulation(const string &encryptedMetadata)
+    {
+        UniqueId encUid;
+        if (!resolveEncId(encryptedMetadata, encUid))
+        {
+            cerr << "错误: 无效的加密元数据格式" << endl;
+            return false;
+        }
+
+        bool erased = encCache.erase(encUid);
+        matchCache.eraseEncapsulation(encUid);
+        return erased;
+    }
+
+    // 设置共享任务调度器的工作线程数及预留给交互请求的线程数
+    size_t setWorkerThreads(size_t count, size_t reservedInteractive)
+    {
+        TaskScheduler &scheduler = TaskScheduler::instance();
+        size_t applied = scheduler.setWorkerCount(count, reservedInteractive);
+        cout << "引擎工作线程数: " << applied << "，其中交互预留: " << scheduler.reservedInteractiveCount() << endl;
+        return applied;
+    }
+
+    // 切换派生密钥模式，只影响此后注册的节点；已按派生模式注册的节点始终按需重算
+    bool setDerivedNodeKeys(bool enabled, size_t cacheCapacity)
+    {
+        lock_guard<mutex> lock(writerMtx);
+        shared_ptr<EngineState> next = beginWrite();
+        next->derivedNodeKeys = enabled;
+        publish(next);
+
+        nodeKeyCache.setCapacity(cacheCapacity);
+        return enabled;
+    }
+
+    // 性能测量：群组公钥Φ与节点分量压缩存储和完整存储时，封装路径各项运算的耗时与每项的常驻内存
+    GroupKeyStorageBenchmark benchmarkGroupKeyStorage(size_t samples)
+    {
+        GroupKeyStorageBenchmark result = {samples, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0};
+        PFC &pfc = threadPfc();
+        shared_ptr<const EngineState> current = snapshot();
+
+        if (!current->initialized || samples == 0)
+        {
+            cerr << "错误: 系统未初始化或测量次数为0" << endl;
+            return result;
+        }
+
+        try
+        {
+            // 随机点代替H2(GroupID||keyword)、r与成员公钥之和，Φ预先求出(不计时)
+            vector<G1> h2(samples), r(samples);
+            vector<GT> phi(samples), combined(samples);
+            vector<CompressedGT> packed(samples);
+            vector<Big> y(samples);
+            for (size_t i = 0; i < samples; i++)
+            {
+                G1 qSum;
+                pfc.random(h2[i]);
+                pfc.random(r[i]);
+                pfc.random(qSum);
+                pfc.random(y[i]);
+                phi[i] = pfc.pairing(qSum, current->Ppub);
+            }
+
+            typedef chrono::steady_clock Clock;
+            auto averageMicros = [samples](Clock::time_point start)
+            {
+                return chrono::duration<double, micro>(Clock::now() - start).count() / samples;
+            };
+
+            Clock::time_point start = Clock::now();
+            for (size_t i = 0; i < samples; i++)
+            {
+                packed[i] = CompressedGT(phi[i]);
+            }
+            result.compressMicros = averageMicros(start);
+
+            start = Clock::now();
+            for (size_t i = 0; i < samples; i++)
+            {
+                phi[i] = packed[i].value();
+            }
+            result.decompressMicros = averageMicros(start);
+
+            start = Clock::now();
+            for (size_t i = 0; i < samples; i++)
+            {
+                combined[i] = pfc.pairing(h2[i], r[i]) * phi[i];
+            }
+            result.storedBaseMicros = averageMicros(start);
+
+            start = Clock::now();
+            for (size_t i = 0; i < samples; i++)
+            {
+                combined[i] = pfc.pairing(h2[i], r[i]) * packed[i].value();
+            }
+            result.compressedBaseMicros = averageMicros(start);
+
+            start = Clock::now();
+            for (size_t i = 0; i < samples; i++)
+            {
+                pfc.power(combined[i], y[i]);
+            }
+            result.genericPowerMicros = averageMicros(start);
+
+            // 建表开销只在关键词成为热点时付出一次，不计入
+            for (size_t i = 0; i < samples; i++)
+            {
+                pfc.precomp_for_power(combined[i]);
+            }
+            start = Clock::now();
+            for (size_t i = 0; i < samples; i++)
+            {
+                pfc.power(combined[i], y[i]);
+            }
+            result.tablePowerMicros = averageMicros(start);
+
+            // 常驻内存：节点分量与群组Φ按实际的压缩对象计；群组记录另含r点及其坐标空间
+            size_t packedBytes = 0;
+            for (const CompressedGT &value : packed)
+            {
+                packedBytes += value.residentBytes();
+            }
+            size_t groupBase = sizeof(GroupRecord) - sizeof(CompressedGT) + mr_esize(get_mip()->nib - 1);
+            result.storedShareBytes = CompressedGT::uncompressedBytes();
+            result.compressedShareBytes = packedBytes / samples;
+            result.storedGroupBytes = groupBase + CompressedGT::uncompressedBytes();
+            result.compressedGroupBytes = groupBase + result.compressedShareBytes;
+        }
+        catch (const exception &e)
+        {
+            cerr << "群组公钥存储性能测量失败: " << e.what() << endl;
+        }
+
+        return result;
+    }
+
+    // 设置匹配后选择节点的分配策略
+    void setAllocationPolicy(AllocationPolicyKind kind)
+    {
+        allocationPolicy.setPolicy(kind);
+    }
+
+    AllocationPolicyKind currentAllocationPolicy() const
+    {
+        return allocationPolicy.policy();
+    }
+
+    // 更新节点负载信息，供负载相关的分配策略使用
+    void updateNodeLoads(const vector<string> &nodeIds, const vector<NodeLoadInfo> &infos)
+    {
+        if (nodeIds.size() != infos.size())
+        {
+            cerr << "错误: 节点ID与负载信息数量不一致" << endl;
+            return;
+        }
+        allocationPolicy.updateNodeLoads(nodeIds, infos);
+    }
+
+    // 辅助方法：取得当前状态快照(无锁)
+    shared_ptr<const EngineState> snapshot() const
+    {
+        return atomic_load(&state);
+    }
+
+    // 辅助方法：复制当前状态作为待发布的新版本(调用方须持有写锁)
+    shared_ptr<EngineState> beginWrite()
+    {
+        shared_ptr<EngineState> next = make_shared<EngineState>(*snapshot());
+        next->version++;
+        return next;
+    }
+
+    // 辅助方法：发布新版本，此后的读者看到新状态(调用方须持有写锁)
+    void publish(const shared_ptr<EngineState> &next)
+    {
+        atomic_store(&state, shared_ptr<const EngineState>(next));
+    }
+
+    // 辅助方法：按ID检查陷门与封装数据是否匹配
+    bool matchCachedIds(const UniqueId &trapdoorUid, const UniqueId &encUid)
+    {
+        PFC &pfc = threadPfc();
+
+        // 优先使用已验证过的结果
+        bool matched = false;
+        if (matchCache.lookup(trapdoorUid, encUid, matched))
+        {
+            return matched;
+        }
+
+        // 检查缓存中是否存在对应的T和(X,Y)
+        shared_ptr<const G1> T;
+        shared_ptr<const EncRecord> enc;
+        if (!trapdoorCache.find(trapdoorUid, T) || !encCache.find(encUid, enc))
+        {
+            cerr << "错误: 找不到对应的陷门或加密数据" << endl;
+            return false;
+        }
+
+        return evaluateMatch(pfc, trapdoorUid, *T, encUid, *enc);
+    }
+
+    // 辅助方法：对前matched.size()条加密元数据求查询表达式，matched与evaluated为逐字节的结果数组；查询无效时返回false
+    bool scanKeywordQuery(const KeywordQuery &query, const vector<string> &trapdoors, const vector<string> &encryptedMetadataList,
+                          const CancellationToken &token, vector<char> &matched, vector<char> &evaluated, size_t &pairings)
+    {
+        if (!snapshot()->initialized)
+        {
+            cerr << "错误: 系统未初始化" << endl;
+            return false;
+        }
+        if (!query.valid() || query.termCount() > trapdoors.size())
+        {
+            cerr << "错误: 无效的关键词查询" << endl;
+            return false;
+        }
+
+        // 陷门只解析一次；无效的陷门视为不匹配
+        vector<UniqueId> trapdoorUids(trapdoors.size());
+        vector<shared_ptr<const G1>> trapdoorPoints(trapdoors.size());
+        for (size_t t = 0; t < trapdoors.size(); t++)
+        {
+            if (!resolveTrapdoorId(trapdoors[t], trapdoorUids[t]) || !trapdoorCache.find(trapdoorUids[t], trapdoorPoints[t]))
+            {
+                cerr << "错误: 无效的陷门格式" << endl;
+            }
+        }
+
+        QueryPlanner planner(query);
+        atomic<size_t> pairingCount(0);
+        parallelFor(matched.size(), QUERY_MATCH_GRAIN, [&](size_t begin, size_t end)
+        {
+            PFC &workerPfc = threadPfc();
+            QueryPlanner::Plan plan;
+            vector<signed char> termResults(trapdoors.size());
+            for (size_t i = begin; i < end && !token.stopRequested(); i++)
+            {
+                evaluated[i] = 1;
+                if ((i - begin) % QUERY_REPLAN_INTERVAL == 0)
+                {
+                    plan = planner.plan();
+                }
+
+                // 每条记录只解码一次，同一陷门在表达式中多次出现时只求值一次
+                UniqueId encUid;
+                shared_ptr<const EncRecord> record;
+                if (!resolveEncId(encryptedMetadataList[i], encUid) || !encCache.find(encUid, record))
+                {
+                    cerr << "错误: 无效的加密元数据格式" << endl;
+                    continue;
+                }
+                fill(termResults.begin(), termResults.end(), -1);
+                bool isMatch = planner.evaluate(plan, [&](size_t term)
+                {
+                    if (termResults[term] < 0)
+                    {
+                        bool termMatch = false;
+                        if (trapdoorPoints[term] && !matchCache.lookup(trapdoorUids[term], encUid, termMatch))
+                        {
+                            termMatch = evaluateMatch(workerPfc, trapdoorUids[term], *trapdoorPoints[term], encUid, *record);
+                            pairingCount++;
+                        }
+                        termResults[term] = termMatch ? 1 : 0;
+                        planner.record(term, termMatch);
+                    }
+                    return termResults[term] != 0;
+                });
+                matched[i] = isMatch ? 1 : 0;
+            }
+        });
+
+        pairings = pairingCount.load();
+        return true;
+    }
+
+    // 辅助方法：计算关键字标签 Y = H3((e(H2(GroupID||keyword), r) * phi)^y)
+    Big keywordTag(PFC &pfc, const string &groupId, const GroupRecord &group, const string &keyword, const Big &y)
+    {
+        shared_ptr<const GT> combined = keywordBase(pfc, groupId, group, keyword);
+
+        // 计算 Y = H3(e(H2(GroupID||keyword), r) * phi)^y，热点关键词的底数带有预计算表
+        GT powered = pfc.power(*combined, y);
+        return pfc.hash_to_aes_key(powered);
+    }
+
+    // 辅助方法：取得 e(H2(GroupID||keyword), r) * phi，它只依赖(群组, 关键词)而与每次封装的y无关
+    //
+    // 首次使用时计算并以压缩形式缓存；LRU窗口内再次使用即视为热点，为其建立定基窗口幂预计算表，此后的
+    // 封装既不需要配对，GT幂运算也改为查表。knownHot(已登记词表的关键词)时首次计算即建表。
+    // 群组版本变化(成员或主密钥变化)后条目随之失效。
+    shared_ptr<const GT> keywordBase(PFC &pfc, const string &groupId, const GroupRecord &group, const string &keyword,
+                                     bool knownHot = false)
+    {
+        string cacheKey = groupId + "|" + keyword;
+        KeywordBase entry;
+        if (keywordBases.find(cacheKey, entry) && entry.groupVersion == group.version)
+        {
+            if (entry.table)
+            {
+                return entry.table;
+            }
+
+            // 并发的提升可能各自建表，后写入的覆盖先写入的，结果相同
+            shared_ptr<GT> table = make_shared<GT>(entry.packed->value());
+            pfc.precomp_for_power(*table);
+            keywordBases.insert(cacheKey, KeywordBase{nullptr, table, group.version});
+            return table;
+        }
+
+        G1 h2_value = *keywordPoint(pfc, groupId, keyword);
+
+        // 计算 e(H2(GroupID||keyword), r) * phi
+        GT e_h2_r = pfc.pairing(h2_value, group.r);
+        shared_ptr<GT> combined = make_shared<GT>(e_h2_r * group.phi.value());
+        if (knownHot)
+        {
+            pfc.precomp_for_power(*combined);
+            keywordBases.insert(cacheKey, KeywordBase{nullptr, combined, group.version});
+        }
+        else
+        {
+            keywordBases.insert(cacheKey, KeywordBase{make_shared<CompressedGT>(*combined), nullptr, group.version});
+        }
+        return combined;
+    }
+
+    // 辅助方法：取得 H2(GroupID||keyword)，它与群组成员和主密钥都无关，按LRU缓存
+    shared_ptr<const G1> keywordPoint(PFC &pfc, const string &groupId, const string &keyword)
+    {
+        string cacheKey = groupId + "|" + keyword;
+        shared_ptr<const G1> point;
+        if (keywordPoints.find(cacheKey, point))
+        {
+            return point;
+        }
+
+        // 构建完整的GroupID||keyword
+        string fullGroupId = groupId + keyword;
+
+        // 计算 H2(GroupID||keyword)
+        shared_ptr<G1> h2_value = make_shared<G1>();
+        hashStringToG1(pfc, fullGroupId, *h2_value);
+
+        keywordPoints.insert(cacheKey, h2_value);
+        return h2_value;
+    }
+
+    // 辅助方法：验证 Y == H3(e(T, X)) 并记录结果，T可以是带配对预计算表的副本
+    bool evaluateMatch(PFC &pfc, const UniqueId &trapdoorUid, const G1 &T, const UniqueId &encUid, const EncRecord &enc)
+    {
+        // 计算配对 e(T, X)
+        GT pairingResult = pfc.pairing(T, enc.X);
+
+        // 计算 H3(e(T, X))
+        Big hashResult = pfc.hash_to_aes_key(pairingResult);
+
+        // 验证 Y == H3(e(T, X))，多关键字记录中任一Y相等即匹配，并记录结果
+        bool matched = false;
+        for (size_t i = 0; i < enc.Y.size() && !matched; i++)
+        {
+            matched = (enc.Y[i] == hashResult);
+        }
+        matchCache.insert(trapdoorUid, encUid, matched);
+        return matched;
+    }
+
+    // 辅助方法：从陷门字符串中解析陷门ID
+    bool resolveTrapdoorId(const string &trapdoor, UniqueId &trapdoorUid)
+    {
+        string trapdoorId, groupId, keyword;
+        return parseTrapdoor(trapdoor, trapdoorId, groupId, keyword) &&
+               parseTaggedId(trapdoorId, TRAPDOOR_ID_PREFIX, trapdoorUid);
+    }
+
+    // 辅助方法：从加密元数据中解析封装ID
+    bool resolveEncId(const string &encryptedMetadata, UniqueId &encUid)
+    {
+        string encId;
+        return parseEncryptedMetadata(encryptedMetadata, encId) &&
+               parseTaggedId(encId, ENC_ID_PREFIX, encUid);
+    }
+
+    // 将并行写入的逐字节处理标记转为结果数组，有条目未处理时返回令牌的停止原因
+    static BatchStatus collectEvaluated(const vector<char> &flags, vector<bool> &evaluated, const CancellationToken &token)
+    {
+        bool complete = true;
+        for (size_t i = 0; i < flags.size(); i++)
+        {
+            evaluated[i] = flags[i] != 0;
+            complete = complete && evaluated[i];
+        }
+        return complete ? BatchStatus::Completed : token.stopReason();
+    }
+
+    // 辅助方法：节点重新注册后，在包含该节点的每个群组中以新分量替换旧分量并更新版本号，
+    // 使其陷门记忆失效(已发出的陷门仍可用于验证)；之后的退出减去的是新分量，r、Φ与树的部分和保持一致
+    void reaggregateNodeGroups(PFC &pfc, EngineState &next, const string &nodeId,
+                               const shared_ptr<const NodeRecord> &oldKeys,
+                               const shared_ptr<const NodeRecord> &newKeys)
+    {
+        shared_ptr<const set<string>> groupIds = next.nodeGroups.find(nodeId);
+        if (!groupIds)
+        {
+            return;
+        }
+        Big order = pfc.order();
+        for (const auto &groupId : *groupIds)
+        {
+            shared_ptr<const GroupRecord> group = next.groups.find(groupId);
+            if (!group)
+            {
+                continue;
+            }
+            shared_ptr<GroupRecord> updated = make_shared<GroupRecord>(*group);
+            if (oldKeys != newKeys)
+            {
+                if (updated->tree)
+                {
+                    updated->tree = GroupTree::replace(updated->tree, nodeId, *oldKeys, *newKeys, order);
+                    updated->r = updated->tree->r;
+                    updated->phi = updated->tree->phi;
+                }
+                else
+                {
+                    updated->r = updated->r + (-oldKeys->xiP) + newKeys->xiP;
+                    updated->phi = CompressedGT(updated->phi.value() / oldKeys->phiPart.value() * newKeys->phiPart.value());
+                }
+            }
+            updated->version = next.version;
+            next.groups.set(groupId, updated);
+        }
+    }
+
+    // 辅助方法：缓存新生成的陷门并返回 "trapdoorId|groupId|keyword"
+    string issueTrapdoor(const shared_ptr<const G1> &T, const string &memoKey, uint64_t groupVersion,
+                         const string &groupId, const string &keyword)
+    {
+        // 生成唯一ID
+        UniqueId trapdoorUid = UniqueIdGenerator::instance().next();
+        string trapdoorId = TRAPDOOR_ID_PREFIX + trapdoorUid.toString();
+
+        // 缓存陷门T供后续验证，并记录(群组, 关键词)对应的陷门
+        trapdoorCache.insert(trapdoorUid, T);
+        trapdoorMemo.insert(memoKey, TrapdoorMemoEntry{trapdoorUid, groupVersion});
+
+        // 返回格式: "trapdoorId|groupId|keyword"
+        return trapdoorId + "|" + groupId + "|" + keyword;
+    }
+
+    // 辅助方法：在群组记录上增删成员并增量更新 r 与 Φ，changed输出实际变动的成员；成员将为空时返回false
+    bool applyMembership(PFC &pfc, const EngineState &next, const string &groupId, const vector<string> &nodeIds,
+                         const vector<shared_ptr<const NodeRecord>> &keys, bool add, GroupRecord &group,
+                         vector<string> &changed)
+    {
+        Big order = pfc.order();
+        set<string> seen;
+        GT phi = group.tree ? GT(1) : group.phi.value(); // 平铺群组的Φ解压一次，全部成员更新后再压缩
+        for (size_t i = 0; i < nodeIds.size(); i++)
+        {
+            const string &nodeId = nodeIds[i];
+            shared_ptr<const set<string>> groups = next.nodeGroups.find(nodeId);
+            bool member = groups && groups->count(groupId) > 0;
+            if (member == add || !seen.insert(nodeId).second)
+            {
+                continue;
+            }
+            changed.push_back(nodeId);
+
+            if (group.tree)
+            {
+                group.tree = add ? GroupTree::insert(group.tree, nodeId, *keys[i], order,
+                                                     [&](const string &id) -> shared_ptr<const NodeRecord>
+                                                     {
+                                                         shared_ptr<const NodeRecord> stored = next.nodes.find(id);
+                                                         return stored ? nodeKeys(pfc, next, id, stored) : stored;
+                                                     })
+                                 : GroupTree::erase(group.tree, nodeId, *keys[i], order);
+                continue;
+            }
+
+            if (add)
+            {
+                group.members.push_back(nodeId);
+                group.r = group.r + keys[i]->xiP;
+                phi = phi * keys[i]->phiPart.value();
+            }
+            else
+            {
+                group.members.erase(find(group.members.begin(), group.members.end(), nodeId));
+                group.r = group.r + (-keys[i]->xiP);
+                phi = phi / keys[i]->phiPart.value();
+            }
+        }
+
+        if (group.tree)
+        {
+            if (group.tree->memberCount == 0)
+            {
+                cerr << "错误: 群组成员不能为空" << endl;
+                return false;
+            }
+            group.r = group.tree->r;
+            group.phi = group.tree->phi;
+        }
+        else if (group.members.empty())
+        {
+            cerr << "错误: 群组成员不能为空" << endl;
+            return false;
+        }
+        else
+        {
+            group.phi = CompressedGT(phi);
+        }
+        return true;
+    }
+
+    // 辅助方法：由成员注册时预计算的分量求群组公钥 r = Σxi*P 与 Φ = Π e(qi, Ppub)，被取消时返回false
+    //
+    // 双线性保证 e(Σqi, Ppub) = Π e(qi, Ppub)，因此建组只需点加与GT乘法，不再需要配对。
+    static bool computeGroupKeys(const vector<shared_ptr<const NodeRecord>> &records,
+                                 const CancellationToken &token, G1 &r, CompressedGT &phi)
+    {
+        // 按块并行计算部分和 r_c = Σxi*P 与部分积 Φ_c = Π e(qi, Ppub)
+        size_t chunkCount = (records.size() + GROUP_GENERATION_GRAIN - 1) / GROUP_GENERATION_GRAIN;
+        vector<PointAccumulator> partialR(chunkCount);
+        vector<GT> partialPhi(chunkCount, GT(1));
+
+        parallelFor(chunkCount, 1, [&](size_t chunkBegin, size_t chunkEnd)
+        {
+            for (size_t c = chunkBegin; c < chunkEnd && !token.stopRequested(); c++)
+            {
+                size_t begin = c * GROUP_GENERATION_GRAIN;
+                size_t end = min(records.size(), begin + GROUP_GENERATION_GRAIN);
+                for (size_t i = begin; i < end; i++)
+                {
+                    partialR[c].add(records[i]->xiP);
+                    partialPhi[c] = partialPhi[c] * records[i]->phiPart.value();
+                }
+            }
+        });
+
+        // 部分结果不完整时没有意义，归约之前再检查一次
+        if (token.stopRequested())
+        {
+            return false;
+        }
+
+        // 并行树形归约得到 r = Σr_c 与 Φ = ΠΦ_c，最后归一化为仿射坐标并压缩Φ
+        parallelTreeReduce(partialR, partialPhi);
+        r = partialR[0].toAffine();
+        phi = CompressedGT(partialPhi[0]);
+        return true;
+    }
+
+    // 辅助方法：并行树形归约，将点的部分和与GT的部分积分别归约到下标0处
+    static void parallelTreeReduce(vector<PointAccumulator> &sums, vector<GT> &products)
+    {
+        size_t count = sums.size();
+        for (size_t stride = 1; stride < count; stride *= 2)
+        {
+            // 本轮将下标 i 与 i+stride 合并，i 为 2*stride 的倍数
+            size_t pairs = (count + 2 * stride - 1) / (2 * stride);
+            parallelFor(pairs, 1, [&](size_t begin, size_t end)
+            {
+                for (size_t p = begin; p < end; p++)
+                {
+                    size_t i = p * 2 * stride;
+                    if (i + stride < count)
+                    {
+                        sums[i].add(sums[i + stride]);
+                        products[i] = products[i] * products[i + stride];
+                    }
+                }
+            });
+        }
+    }
+
+    // 节点密钥提取结果
+    struct NodeKeyMaterial
+    {
+        G1 qi;                // 节点公钥 qi = H1(ID)
+        G1 si;                // 节点私钥 si = s*qi
+        Big xi;               // 随机值xi
+        G1 xiP;               // xi*P
+        CompressedGT phiPart; // e(qi, Ppub)(压缩存储)
+        string privateKeyStr; // 私钥哈希值的字符串形式
+        bool derived;         // 派生密钥模式下只计算私钥哈希，不存储密钥材料
+    };
+
+    // 辅助方法：为节点提取密钥并预计算其群组公钥分量(只读取不可变快照，可在工作线程上调用)
+    static void extractNodeKey(PFC &pfc, const string &nodeId, const EngineState &current, bool derived, NodeKeyMaterial &material)
+    {
+        hashStringToG1(pfc, nodeId, material.qi);
+
+        // 计算节点私钥 si = s*qi
+        material.si = pfc.mult(material.qi, current.s);
+
+        // 计算私钥的哈希值作为字符串返回
+        pfc.start_hash();
+        pfc.add_to_hash(material.si);
+        Big si_hash = pfc.finish_hash_to_group();
+
+        stringstream ss;
+        ss << si_hash;
+        material.privateKeyStr = ss.str();
+
+        // 派生密钥模式下xi与群组公钥分量在使用时由deriveNodeRecord重新计算
+        material.derived = derived;
+        if (derived)
+        {
+            return;
+        }
+
+        // 生成随机数xi (将在群组生成阶段使用)
+        pfc.random(material.xi);
+        while (material.xi == 0)
+        {
+            pfc.random(material.xi);
+        }
+
+        // 群组公钥分量在注册时计算一次，此后由该节点参与的任何群组都只需点加与GT乘法
+        material.xiP = pfc.mult(current.P, material.xi);
+        material.phiPart = CompressedGT(pfc.pairing(material.qi, current.Ppub));
+    }
+
+    // 辅助方法：派生密钥模式下重新计算节点的全部密钥材料，xi = H(nodeKeySeed, qi)
+    static shared_ptr<const NodeRecord> deriveNodeRecord(PFC &pfc, const string &nodeId, const EngineState &current)
+    {
+        shared_ptr<NodeRecord> record = make_shared<NodeRecord>();
+        hashStringToG1(pfc, nodeId, record->qi);
+        record->si = pfc.mult(record->qi, current.s);
+
+        // qi是节点ID的确定性编码，以种子为密钥的哈希作为PRF；结果为0时继续迭代
+        pfc.start_hash();
+        pfc.add_to_hash(current.nodeKeySeed);
+        pfc.add_to_hash(record->qi);
+        record->xi = pfc.finish_hash_to_group();
+        while (record->xi == 0)
+        {
+            pfc.start_hash();
+            pfc.add_to_hash(current.nodeKeySeed);
+            pfc.add_to_hash(record->xi);
+            record->xi = pfc.finish_hash_to_group();
+        }
+
+        record->xiP = pfc.mult(current.P, record->xi);
+        record->phiPart = CompressedGT(pfc.pairing(record->qi, current.Ppub));
+        record->keyEpoch = current.keyEpoch;
+        return record;
+    }
+
+    // 辅助方法：取得节点的密钥材料，派生密钥模式下注册的节点经热缓存按需重新计算
+    shared_ptr<const NodeRecord> nodeKeys(PFC &pfc, const EngineState &current, const string &nodeId,
+                                          const shared_ptr<const NodeRecord> &stored)
+    {
+        if (!stored->derived)
+        {
+            return stored;
+        }
+
+        shared_ptr<const NodeRecord> record;
+        if (!nodeKeyCache.find(nodeId, record) || record->keyEpoch != current.keyEpoch)
+        {
+            record = deriveNodeRecord(pfc, nodeId, current);
+            nodeKeyCache.insert(nodeId, record);
+        }
+        return record;
+    }
+
+    // 辅助方法：并行取得一组节点的密钥材料(缓存未命中时每个节点需一次配对)，被取消时返回false
+    bool resolveNodeKeys(const EngineState &current, const vector<string> &nodeIds,
+                         const vector<shared_ptr<const NodeRecord>> &stored, const CancellationToken &token,
+                         vector<shared_ptr<const NodeRecord>> &keys)
+    {
+        keys.assign(stored.size(), shared_ptr<const NodeRecord>());
+        parallelFor(stored.size(), NODE_REGISTRATION_GRAIN, [&](size_t begin, size_t end)
+        {
+            PFC &workerPfc = threadPfc();
+            for (size_t i = begin; i < end && !token.stopRequested(); i++)
+            {
+                keys[i] = nodeKeys(workerPfc, current, nodeIds[i], stored[i]);
+            }
+        });
+        return !token.stopRequested();
+    }
+
+    // 辅助方法：按比例k轮换节点的密钥材料；派生密钥模式的占位记录不含密钥材料，原样返回
+    static shared_ptr<const NodeRecord> rekeyNode(PFC &pfc, const shared_ptr<const NodeRecord> &record, const Big &k)
+    {
+        if (record->derived)
+        {
+            return record;
+        }
+        shared_ptr<NodeRecord> rekeyed = make_shared<NodeRecord>(*record);
+        rekeyed->si = pfc.mult(record->si, k);
+        rekeyed->phiPart = CompressedGT(pfc.power(record->phiPart.value(), k));
+        return rekeyed;
+    }
+
+    // 辅助方法：按比例k轮换群组公钥Φ(层次群组的每个树节点都缓存了Φ的部分积)，版本号由调用方设置
+    static shared_ptr<GroupRecord> rekeyGroup(PFC &pfc, const GroupRecord &group, const Big &k)
+    {
+        shared_ptr<GroupRecord> rekeyed = make_shared<GroupRecord>(group);
+        if (group.tree)
+        {
+            rekeyed->tree = GroupTree::rekey(group.tree, [&k](const GT &phi) { return threadPfc().power(phi, k); });
+            rekeyed->phi = rekeyed->tree->phi;
+        }
+        else
+        {
+            rekeyed->phi = CompressedGT(pfc.power(group.phi.value(), k));
+        }
+        return rekeyed;
+    }
+
+    // 辅助方法：以当前版本的第index个分片为准合并轮换结果：条目与轮换基于的版本相同时取已轮换的值，
+    // 否则(轮换期间新写入或修改)用rekey当场轮换(调用方须持有写锁)
+    template <typename V>
+    static shared_ptr<typename SnapshotMap<V>::Shard> mergeRekeyed(
+        const SnapshotMap<V> &current, const SnapshotMap<V> &base, size_t index,
+        const typename SnapshotMap<V>::Shard &rekeyed,
+        const function<shared_ptr<const V>(const shared_ptr<const V> &)> &rekey)
+    {
+        shared_ptr<typename SnapshotMap<V>::Shard> merged = make_shared<typename SnapshotMap<V>::Shard>(current.shard(index));
+        for (auto &entry : *merged)
+        {
+            auto it = rekeyed.find(entry.first);
+            if (it != rekeyed.end() && base.find(entry.first) == entry.second)
+            {
+                entry.second = it->second;
+            }
+            else
+            {
+                entry.second = rekey(entry.second);
+            }
+        }
+        return merged;
+    }
+
+    // 辅助方法：将提取的节点密钥写入待发布的新版本(调用方须持有写锁)
+    void commitNodeKey(PFC &pfc, EngineState &next, const string &nodeId, const NodeKeyMaterial &material)
+    {
+        shared_ptr<const NodeRecord> previous = next.nodes.find(nodeId);
+
+        // 存储节点公钥、私钥和随机值；派生密钥模式下只记录节点已注册
+        shared_ptr<const NodeRecord> stored = derivedNodeRecord;
+        if (!material.derived)
+        {
+            shared_ptr<NodeRecord> record = make_shared<NodeRecord>();
+            record->qi = material.qi;
+            record->si = material.si;
+            record->xi = material.xi;
+            record->xiP = material.xiP;
+            record->phiPart = material.phiPart;
+            stored = record;
+        }
+        next.nodes.set(nodeId, stored);
+
+        // 重新注册会更换节点密钥，其所在群组的聚合值随之更新；
+        // 派生密钥由节点ID与种子确定，前后都是派生模式时分量不变
+        if (previous)
+        {
+            bool unchanged = previous->derived && stored->derived;
+            reaggregateNodeGroups(pfc, next, nodeId, unchanged ? stored : nodeKeys(pfc, next, nodeId, previous),
+                                  unchanged ? stored : nodeKeys(pfc, next, nodeId, stored));
+        }
+    }
+
+    // 辅助方法：解析带前缀的ID(如"td_XXXX")
+    bool parseTaggedId(const string &taggedId, const string &prefix, UniqueId &id)
+    {
+        // 注意: MIRACL头文件中存在compare宏，这里避免使用string::compare
+        if (taggedId.size() < prefix.size() || taggedId.substr(0, prefix.size()) != prefix)
+        {
+            return false;
+        }
+        return UniqueId::fromString(taggedId.substr(prefix.size()), id);
+    }
+
+    // 辅助方法：解析陷门
+    bool parseTrapdoor(const string &trapdoor, string &trapdoorId, string &groupId, string &keyword)
+    {
+        size_t pos1 = trapdoor.find('|');
+        if (pos1 == string::npos)
+        {
+            return false;
+        }
+
+        size_t pos2 = trapdoor.find('|', pos1 + 1);
+        if (pos2 == string::npos)
+        {
+            return false;
+        }
+
+        trapdoorId = trapdoor.substr(0, pos1);
+        groupId = trapdoor.substr(pos1 + 1, pos2 - pos1 - 1);
+        keyword = trapdoor.substr(pos2 + 1);
+        return true;
+    }
+
+    // 辅助方法：解析加密元数据
+    bool parseEncryptedMetadata(const string &metadata, string &encId)
+    {
+        // 假设metadata是JSON格式，解析出id字段
+        size_t idPos = metadata.find("\"id\"");
+        if (idPos == string::npos)
+        {
+            return false;
+        }
 
         idPos = metadata.find(":", idPos);
         if (idPos == string::npos)
@@ -624,9 +2418,19 @@ CryptoEngineImpl::~CryptoEngineImpl()
 {
 }
 
-bool CryptoEngineImpl::systemSetup(int securityLevel)
+bool CryptoEngineImpl::systemSetup(int securityLevel, int nodeTag)
+{
+    return pImpl->systemSetup(securityLevel, nodeTag);
+}
+
+uint64_t CryptoEngineImpl::rotateMasterKey(const CancellationToken &token, BatchStatus &status)
+{
+    return pImpl->rotateMasterKey(token, status);
+}
+
+uint64_t CryptoEngineImpl::keyEpoch() const
 {
-    return pImpl->systemSetup(securityLevel);
+    return pImpl->currentKeyEpoch();
 }
 
 pair<string, string> CryptoEngineImpl::nodeRegistration(const string &nodeId)
@@ -634,9 +2438,53 @@ pair<string, string> CryptoEngineImpl::nodeRegistration(const string &nodeId)
     return pImpl->nodeRegistration(nodeId);
 }
 
+vector<pair<string, string>> CryptoEngineImpl::nodeRegistrationBatch(const vector<string> &nodeIds)
+{
+    return pImpl->nodeRegistrationBatch(nodeIds);
+}
+
 string CryptoEngineImpl::groupGeneration(const vector<string> &nodeIds)
 {
-    return pImpl->groupGeneration(nodeIds);
+    BatchStatus status;
+    return pImpl->groupGeneration(nodeIds, CancellationToken::none(), status, GroupLayout::Flat);
+}
+
+string CryptoEngineImpl::groupGeneration(const vector<string> &nodeIds, const CancellationToken &token, BatchStatus &status,
+                                         GroupLayout layout)
+{
+    return pImpl->groupGeneration(nodeIds, token, status, layout);
+}
+
+bool CryptoEngineImpl::groupAddMembers(const string &groupId, const vector<string> &nodeIds)
+{
+    return pImpl->updateGroupMembers(groupId, nodeIds, true);
+}
+
+bool CryptoEngineImpl::groupRemoveMembers(const string &groupId, const vector<string> &nodeIds)
+{
+    return pImpl->updateGroupMembers(groupId, nodeIds, false);
+}
+
+size_t CryptoEngineImpl::registerGroupVocabulary(const string &groupId, const vector<string> &keywords, bool precomputeBases,
+                                                 const CancellationToken &token, BatchStatus &status)
+{
+    return pImpl->registerGroupVocabulary(groupId, keywords, precomputeBases, token, status);
+}
+
+string CryptoEngineImpl::encapsulateKeywords(const vector<string> &keywords, const string &groupId)
+{
+    return pImpl->encapsulateKeywords(keywords, groupId);
+}
+
+vector<string> CryptoEngineImpl::encapsulateKeywordBatch(const vector<string> &keywords, const string &groupId)
+{
+    return pImpl->encapsulateKeywordBatch(keywords, groupId, CancellationToken::none()).encapsulations;
+}
+
+EncapsulationBatchResult CryptoEngineImpl::encapsulateKeywordBatch(const vector<string> &keywords, const string &groupId,
+                                                                   const CancellationToken &token)
+{
+    return pImpl->encapsulateKeywordBatch(keywords, groupId, token);
 }
 
 string CryptoEngineImpl::searchTokenGeneration(const string &keyword, const string &key)
@@ -649,6 +2497,24 @@ bool CryptoEngineImpl::verifyKeywordMatch(const string &trapdoor, const string &
     return pImpl->verifyKeywordMatch(trapdoor, encryptedMetadata);
 }
 
+vector<bool> CryptoEngineImpl::verifyKeywordMatchBatch(const vector<string> &trapdoors,
+                                                      const vector<string> &encryptedMetadataList)
+{
+    return pImpl->verifyKeywordMatchBatch(trapdoors, encryptedMetadataList, CancellationToken::none()).matched;
+}
+
+VerifyBatchResult CryptoEngineImpl::verifyKeywordMatchBatch(const vector<string> &trapdoors,
+                                                           const vector<string> &encryptedMetadataList,
+                                                           const CancellationToken &token)
+{
+    return pImpl->verifyKeywordMatchBatch(trapdoors, encryptedMetadataList, token);
+}
+
+bool CryptoEngineImpl::supportsBackgroundThreads()
+{
+    return miraclSupportsThreads();
+}
+
 string CryptoEngineImpl::encapsulateKeyword(const string &keyword, const string &metadata)
 {
     return pImpl->encapsulateKeyword(keyword, metadata);
@@ -659,5 +2525,106 @@ string CryptoEngineImpl::allocateResourcesAccordingToKeywords(
     const vector<string> &encryptedMetadataList,
     const vector<string> &edgeNodeIds)
 {
-    return pImpl->allocateResourcesAccordingToKeywords(trapdoor, encryptedMetadataList, edgeNodeIds);
+    return pImpl->allocateResourcesAccordingToKeywords(trapdoor, encryptedMetadataList, edgeNodeIds,
+                                                       CancellationToken::none(), 1.0).nodeId;
+}
+
+AllocationResult CryptoEngineImpl::allocateResourcesAccordingToKeywords(
+    const string &trapdoor,
+    const vector<string> &encryptedMetadataList,
+    const vector<string> &edgeNodeIds,
+    const CancellationToken &token,
+    double demand)
+{
+    return pImpl->allocateResourcesAccordingToKeywords(trapdoor, encryptedMetadataList, edgeNodeIds, token, demand);
+}
+
+RankedAllocationResult CryptoEngineImpl::allocateTopK(
+    const string &trapdoor,
+    const vector<string> &encryptedMetadataList,
+    const vector<string> &edgeNodeIds,
+    size_t k,
+    const CancellationToken &token,
+    double demand)
+{
+    return pImpl->allocateTopK(trapdoor, encryptedMetadataList, edgeNodeIds, k, token, demand);
+}
+
+BatchAllocationResult CryptoEngineImpl::allocateBatch(
+    const vector<string> &trapdoors,
+    const vector<string> &encryptedMetadataList,
+    const vector<string> &edgeNodeIds,
+    const CancellationToken &token,
+    double demand)
+{
+    return pImpl->allocateBatch(trapdoors, encryptedMetadataList, edgeNodeIds, token, demand);
+}
+
+QueryMatchResult CryptoEngineImpl::matchKeywordQuery(
+    const KeywordQuery &query,
+    const vector<string> &trapdoors,
+    const vector<string> &encryptedMetadataList,
+    const CancellationToken &token)
+{
+    return pImpl->matchKeywordQuery(query, trapdoors, encryptedMetadataList, token);
+}
+
+AllocationResult CryptoEngineImpl::allocateByKeywordQuery(
+    const KeywordQuery &query,
+    const vector<string> &trapdoors,
+    const vector<string> &encryptedMetadataList,
+    const vector<string> &edgeNodeIds,
+    const CancellationToken &token,
+    double demand)
+{
+    return pImpl->allocateByKeywordQuery(query, trapdoors, encryptedMetadataList, edgeNodeIds, token, demand);
+}
+
+bool CryptoEngineImpl::setDerivedNodeKeys(bool enabled, size_t cacheCapacity)
+{
+    return pImpl->setDerivedNodeKeys(enabled, cacheCapacity);
+}
+
+GroupKeyStorageBenchmark CryptoEngineImpl::benchmarkGroupKeyStorage(size_t samples)
+{
+    return pImpl->benchmarkGroupKeyStorage(samples);
+}
+
+void CryptoEngineImpl::setAllocationPolicy(AllocationPolicyKind kind)
+{
+    pImpl->setAllocationPolicy(kind);
+}
+
+AllocationPolicyKind CryptoEngineImpl::allocationPolicy() const
+{
+    return pImpl->currentAllocationPolicy();
+}
+
+void CryptoEngineImpl::updateNodeLoads(const vector<string> &nodeIds, const vector<NodeLoadInfo> &infos)
+{
+    pImpl->updateNodeLoads(nodeIds, infos);
+}
+
+MatchScanResult CryptoEngineImpl::streamKeywordMatches(
+    const string &trapdoor,
+    const vector<string> &encryptedMetadataList,
+    const MatchSink &sink,
+    const CancellationToken &token)
+{
+    return pImpl->streamKeywordMatches(trapdoor, encryptedMetadataList, sink, token);
+}
+
+bool CryptoEngineImpl::releaseTrapdoor(const string &trapdoor)
+{
+    return pImpl->releaseTrapdoor(trapdoor);
+}
+
+bool CryptoEngineImpl::releaseEncapsulation(const string &encryptedMetadata)
+{
+    return pImpl->releaseEncapsulation(encryptedMetadata);
+}
+
+size_t CryptoEngineImpl::setWorkerThreads(size_t count, size_t reservedInteractive)
+{
+    return pImpl->setWorkerThreads(count, reservedInteractive);
 }
@@ -13,6 +13,8 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
+#include <cstdint>
 
 // 在包含MIRACL头文件前，定义必要的宏
 // 移除 MR_GENERIC_AND_STATIC 宏定义，因为它导致mirsys函数参数不匹配
@@ -38,6 +40,111 @@
 
 // 包含主类定义
 #include "crypto_engine.h"
+#include "cancellation.h"
+#include "allocation_policy.h"
+#include "keyword_query.h"
+#include "node_key_cache.h"
+#include "group_tree.h"
+
+/**
+ * @brief 可取消的批量匹配验证结果
+ */
+struct VerifyBatchResult
+{
+    std::vector<bool> matched;   // 与输入一一对应的匹配结果
+    std::vector<bool> evaluated; // 对应条目是否已验证(取消或超时后未处理的条目为false)
+    BatchStatus status;
+};
+
+/**
+ * @brief 可取消的批量封装结果
+ */
+struct EncapsulationBatchResult
+{
+    std::vector<std::string> encapsulations; // 未处理或失败的条目为空字符串
+    std::vector<bool> evaluated;
+    BatchStatus status;
+};
+
+/**
+ * @brief 可取消的资源分配结果
+ */
+struct AllocationResult
+{
+    std::string nodeId; // 已检查部分中的分配结果，没有匹配时为空
+    size_t evaluated;   // 已检查的加密元数据数
+    BatchStatus status;
+};
+
+/**
+ * @brief 前k名资源分配结果
+ */
+struct RankedAllocationResult
+{
+    std::vector<std::string> nodeIds; // 按当前分配策略排序的匹配节点(已去重)，最多k个
+    size_t evaluated;                 // 已检查的加密元数据数
+    BatchStatus status;
+};
+
+/**
+ * @brief 多请求批量分配结果
+ */
+struct BatchAllocationResult
+{
+    std::vector<std::string> nodeIds; // 与陷门一一对应的分配节点，没有匹配时为空字符串
+    std::vector<bool> complete;       // 对应请求是否检查了全部加密元数据
+    BatchStatus status;
+};
+
+/**
+ * @brief 多关键词布尔查询的匹配结果
+ */
+struct QueryMatchResult
+{
+    std::vector<bool> matched;   // 与加密元数据一一对应的查询结果
+    std::vector<bool> evaluated; // 对应条目是否已检查
+    size_t pairings;             // 实际执行的配对次数(短路与缓存命中的项不计)
+    BatchStatus status;
+};
+
+/**
+ * @brief 群组公钥Φ压缩存储的开销测量(耗时为每次运算的平均微秒数，内存为每项常驻字节数)
+ *
+ * 节点分量 e(qi, Ppub)、群组公钥Φ与冷关键词底数以环面压缩形式常驻内存，约为完整GT元素的一半；
+ * 使用时解压。常驻字节数含MIRACL为域元素分配的空间，群组一项另含群组公钥r，不含成员列表。
+ */
+struct GroupKeyStorageBenchmark
+{
+    size_t samples;
+    double storedBaseMicros;     // 存储完整Φ时求封装底数：e(H2, r)*Φ
+    double compressedBaseMicros; // 压缩存储Φ时求封装底数：先解压Φ，再 e(H2, r)*Φ
+    double compressMicros;       // 压缩一个GT元素
+    double decompressMicros;     // 解压一个GT元素
+    double genericPowerMicros;   // 冷关键词的GT幂运算 combined^y
+    double tablePowerMicros;     // 热点关键词用定基预计算表的GT幂运算
+    size_t storedShareBytes;     // 完整存储时每个节点分量的常驻字节数
+    size_t compressedShareBytes; // 压缩存储时每个节点分量的常驻字节数
+    size_t storedGroupBytes;     // 完整存储Φ时每个群组记录的常驻字节数
+    size_t compressedGroupBytes; // 压缩存储Φ时每个群组记录的常驻字节数
+};
+
+/**
+ * @brief 流式匹配的结果统计
+ */
+struct MatchScanResult
+{
+    size_t evaluated; // 已检查的加密元数据数
+    size_t matched;   // 已交给回调的匹配数(取消后未回调的不计)
+    BatchStatus status;
+};
+
+/**
+ * @brief 流式匹配的结果回调，参数为一块中匹配的加密元数据下标(块内升序)
+ *
+ * 只在调用streamKeywordMatches的线程上按块顺序调用。匹配按窗口在工作线程上并行检查，
+ * 一个窗口检查完毕后才回调；回调阻塞时扫描在窗口边界暂停(背压)，期间不占用调度器的工作线程。
+ */
+typedef std::function<void(const std::vector<size_t> &matchedIndices)> MatchSink;
 
 /**
  * @brief 加密引擎实现类
@@ -64,9 +171,28 @@ public:
     /**
      * @brief 初始化加密引擎
      * @param securityLevel 安全级别
+     * @param nodeTag 唯一ID前缀中的16位节点标记(0~65535)，多实例部署时每个后端进程应配置不同的值；
+     *                为负时保留进程启动时随机选取的标记
      * @return 初始化是否成功
      */
-    bool systemSetup(int securityLevel = 128);
+    bool systemSetup(int securityLevel = 128, int nodeTag = -1);
+
+    /**
+     * @brief 轮换系统主密钥
+     *
+     * 在后台线程上基于当前快照并行重算全部节点私钥、Ppub与各群组公钥，计算期间其他请求照常处理；
+     * 完成后原子地切换到新的密钥纪元。切换前开始的验证在旧纪元上完成，已发出的陷门仍可匹配旧纪元的
+     * 封装数据，切换后生成的陷门只匹配新纪元的封装数据。
+     * @param token 取消令牌，取消或超时后不切换纪元
+     * @param status 输出结束状态
+     * @return 新的密钥纪元，未完成时为0
+     */
+    uint64_t rotateMasterKey(const CancellationToken &token, BatchStatus &status);
+
+    /**
+     * @brief 当前的密钥纪元(系统初始化后为1，每次轮换递增)
+     */
+    uint64_t keyEpoch() const;
 
     /**
      * @brief 注册一个新节点
@@ -75,6 +201,13 @@ public:
      */
     std::pair<std::string, std::string> nodeRegistration(const std::string &nodeId);
 
+    /**
+     * @brief 批量注册节点，在工作线程上并行提取密钥后一次性写入节点表
+     * @param nodeIds 节点ID列表
+     * @return 与输入一一对应的密钥对，失败的节点为空字符串对
+     */
+    std::vector<std::pair<std::string, std::string>> nodeRegistrationBatch(const std::vector<std::string> &nodeIds);
+
     /**
      * @brief 创建一个新群组
      * @param nodeIds 群组成员节点ID列表
@@ -82,6 +215,48 @@ public:
      */
     std::string groupGeneration(const std::vector<std::string> &nodeIds);
 
+    /**
+     * @brief 可取消的群组生成，取消或超时后不创建群组
+     * @param nodeIds 群组成员节点ID列表
+     * @param token 取消令牌
+     * @param status 输出结束状态
+     * @param layout 群组组织方式；层次群组的成员增删只涉及一条根到叶路径，陷门生成与成员数无关
+     * @return 群组ID，未完成时为空字符串
+     */
+    std::string groupGeneration(const std::vector<std::string> &nodeIds, const CancellationToken &token,
+                                BatchStatus &status, GroupLayout layout = GroupLayout::Flat);
+
+    /**
+     * @brief 向群组加入成员，按新成员的分量增量更新群组公钥(已是成员的节点忽略)
+     * @param groupId 群组ID
+     * @param nodeIds 加入的节点ID
+     * @return 是否成功
+     */
+    bool groupAddMembers(const std::string &groupId, const std::vector<std::string> &nodeIds);
+
+    /**
+     * @brief 从群组移除成员，按成员的分量增量更新群组公钥(不是成员的节点忽略，不允许移除全部成员)
+     * @param groupId 群组ID
+     * @param nodeIds 移除的节点ID
+     * @return 是否成功
+     */
+    bool groupRemoveMembers(const std::string &groupId, const std::vector<std::string> &nodeIds);
+
+    /**
+     * @brief 登记群组的关键词词表，在后台线程上预先求出各关键词的H2(GroupID||keyword)
+     *
+     * 预计算结果放入容量有界的缓存，之后的陷门生成与封装直接使用。群组成员变化或主密钥轮换后，
+     * GT底数在下次使用时按需重算，H2不受影响。
+     * @param groupId 群组ID
+     * @param keywords 关键词列表
+     * @param precomputeBases 是否同时求出封装用的GT底数并建立定基幂预计算表
+     * @param token 取消令牌，取消或超时后已完成的部分仍保留在缓存中
+     * @param status 输出结束状态
+     * @return 已完成预计算的关键词数
+     */
+    size_t registerGroupVocabulary(const std::string &groupId, const std::vector<std::string> &keywords,
+                                   bool precomputeBases, const CancellationToken &token, BatchStatus &status);
+
     /**
      * @brief 生成随机关键字
      * @return 随机生成的关键字
@@ -104,6 +279,29 @@ public:
      */
     bool verifyKeywordMatch(const std::string &trapdoor, const std::string &encryptedMetadata);
 
+    /**
+     * @brief 批量验证关键词匹配，各条验证在共享调度器上并行执行
+     * @param trapdoors 陷门值列表
+     * @param encryptedMetadataList 加密的元数据列表，与trapdoors一一对应
+     * @return 与输入一一对应的匹配结果
+     */
+    std::vector<bool> verifyKeywordMatchBatch(const std::vector<std::string> &trapdoors,
+                                              const std::vector<std::string> &encryptedMetadataList);
+
+    /**
+     * @brief 可取消的批量关键词匹配验证
+     *
+     * 每条验证开始前检查取消令牌，取消或超过截止时间后放弃剩余条目并返回已完成的部分。
+     */
+    VerifyBatchResult verifyKeywordMatchBatch(const std::vector<std::string> &trapdoors,
+                                              const std::vector<std::string> &encryptedMetadataList,
+                                              const CancellationToken &token);
+
+    /**
+     * @brief 引擎是否可以在后台线程上调用(MIRACL以多线程方式编译)
+     */
+    static bool supportsBackgroundThreads();
+
     /**
      * @brief 关键词封装
      * @param keyword 关键词
@@ -112,6 +310,31 @@ public:
      */
     std::string encapsulateKeyword(const std::string &keyword, const std::string &groupId);
 
+    /**
+     * @brief 多关键词封装：一条记录的所有关键词共享同一个随机数与X，每个关键词一个Y
+     *
+     * 任一关键词的陷门都与该记录匹配，验证时只需一次配对。
+     * @param keywords 关键词列表
+     * @param groupId 群组ID
+     * @return 封装后的数据，失败时为空字符串
+     */
+    std::string encapsulateKeywords(const std::vector<std::string> &keywords, const std::string &groupId);
+
+    /**
+     * @brief 批量关键词封装，以批量优先级执行，不占用交互请求的预留线程
+     * @param keywords 关键词列表
+     * @param groupId 群组ID
+     * @return 与输入一一对应的封装结果，失败的条目为空字符串
+     */
+    std::vector<std::string> encapsulateKeywordBatch(const std::vector<std::string> &keywords, const std::string &groupId);
+
+    /**
+     * @brief 可取消的批量关键词封装，取消或超时后返回已完成的部分
+     */
+    EncapsulationBatchResult encapsulateKeywordBatch(const std::vector<std::string> &keywords,
+                                                     const std::string &groupId,
+                                                     const CancellationToken &token);
+
     /**
      * @brief 根据关键词匹配结果分配资源
      * @param trapdoor 陷门值
@@ -124,6 +347,160 @@ public:
         const std::vector<std::string> &encryptedMetadataList,
         const std::vector<std::string> &edgeNodeIds);
 
+    /**
+     * @brief 可取消的资源分配，取消或超时后只在已检查的加密元数据中选择节点
+     * @param demand 本次分配的需求量，选中的节点立即记入该负载
+     */
+    AllocationResult allocateResourcesAccordingToKeywords(
+        const std::string &trapdoor,
+        const std::vector<std::string> &encryptedMetadataList,
+        const std::vector<std::string> &edgeNodeIds,
+        const CancellationToken &token,
+        double demand = 1.0);
+
+    /**
+     * @brief 返回按当前分配策略排名前k的匹配节点，首选节点被拒绝时可直接改用后续节点而无需重新匹配
+     * @param trapdoor 陷门值
+     * @param encryptedMetadataList 加密元数据列表
+     * @param edgeNodeIds 与加密元数据一一对应的边缘节点列表
+     * @param k 最多返回的节点数
+     * @param token 取消令牌
+     * @param demand 需求量，只记入排名第一的节点
+     */
+    RankedAllocationResult allocateTopK(
+        const std::string &trapdoor,
+        const std::vector<std::string> &encryptedMetadataList,
+        const std::vector<std::string> &edgeNodeIds,
+        size_t k,
+        const CancellationToken &token,
+        double demand = 1.0);
+
+    /**
+     * @brief 多请求批量分配：一组陷门对同一组加密元数据匹配，并按请求顺序依次分配节点
+     *
+     * 陷门×加密元数据矩阵按块并行计算，每条加密元数据在整轮中只解码一次，
+     * 块内的陷门共享配对预计算表。
+     * @param trapdoors 各请求的陷门
+     * @param encryptedMetadataList 加密元数据列表
+     * @param edgeNodeIds 与加密元数据一一对应的边缘节点列表
+     * @param token 取消令牌
+     * @param demand 每个请求的需求量
+     */
+    BatchAllocationResult allocateBatch(
+        const std::vector<std::string> &trapdoors,
+        const std::vector<std::string> &encryptedMetadataList,
+        const std::vector<std::string> &edgeNodeIds,
+        const CancellationToken &token,
+        double demand = 1.0);
+
+    /**
+     * @brief 多关键词布尔查询：对每条加密元数据求AND/OR表达式
+     *
+     * AND遇到不匹配、OR遇到匹配后不再计算其余陷门的配对；各陷门按扫描中观测到的
+     * 匹配率排序，最可能使表达式短路的陷门先求值。
+     * @param query 查询表达式，陷门项为trapdoors中的下标
+     * @param trapdoors 查询引用的陷门
+     * @param encryptedMetadataList 加密元数据列表
+     * @param token 取消令牌
+     */
+    QueryMatchResult matchKeywordQuery(
+        const KeywordQuery &query,
+        const std::vector<std::string> &trapdoors,
+        const std::vector<std::string> &encryptedMetadataList,
+        const CancellationToken &token);
+
+    /**
+     * @brief 按多关键词布尔查询分配资源，在满足查询的节点中由当前分配策略选择
+     * @param query 查询表达式，陷门项为trapdoors中的下标
+     * @param trapdoors 查询引用的陷门
+     * @param encryptedMetadataList 加密元数据列表
+     * @param edgeNodeIds 与加密元数据一一对应的边缘节点列表
+     * @param token 取消令牌
+     * @param demand 本次分配的需求量
+     */
+    AllocationResult allocateByKeywordQuery(
+        const KeywordQuery &query,
+        const std::vector<std::string> &trapdoors,
+        const std::vector<std::string> &encryptedMetadataList,
+        const std::vector<std::string> &edgeNodeIds,
+        const CancellationToken &token,
+        double demand = 1.0);
+
+    /**
+     * @brief 切换派生密钥模式
+     *
+     * 开启后新注册的节点不再存储si与xi：si = s*H1(ID)在使用时重新计算，xi由以系统初始化时
+     * 选取的种子为密钥的PRF从节点ID派生，近期使用的节点保存在有界的LRU热缓存中。
+     * 已注册的节点保持注册时的模式。
+     * @param enabled 是否开启
+     * @param cacheCapacity 热缓存最多保存的节点数
+     * @return 当前是否处于派生密钥模式
+     */
+    bool setDerivedNodeKeys(bool enabled, size_t cacheCapacity = NodeKeyCache::DEFAULT_CAPACITY);
+
+    /**
+     * @brief 在当前系统参数上测量群组公钥压缩存储的耗时与常驻内存(随机点，不修改引擎状态)
+     *
+     * 仅供C++侧的性能评估使用，不导出到Node.js绑定。
+     * @param samples 每项测量的运算次数
+     */
+    GroupKeyStorageBenchmark benchmarkGroupKeyStorage(size_t samples);
+
+    /**
+     * @brief 设置匹配后在候选节点中选择目标节点的策略(默认为第一个匹配)
+     */
+    void setAllocationPolicy(AllocationPolicyKind kind);
+
+    /**
+     * @brief 当前的分配策略
+     */
+    AllocationPolicyKind allocationPolicy() const;
+
+    /**
+     * @brief 批量更新节点的负载、容量与权重
+     * @param nodeIds 节点ID列表
+     * @param infos 与nodeIds一一对应的负载信息
+     */
+    void updateNodeLoads(const std::vector<std::string> &nodeIds, const std::vector<NodeLoadInfo> &infos);
+
+    /**
+     * @brief 流式关键词匹配：各块检查完成后立即把其中匹配的下标交给回调，不等待全部完成
+     * @param trapdoor 陷门值
+     * @param encryptedMetadataList 加密元数据列表
+     * @param sink 结果回调
+     * @param token 取消令牌
+     * @return 已检查数、匹配数与结束状态
+     */
+    MatchScanResult streamKeywordMatches(
+        const std::string &trapdoor,
+        const std::vector<std::string> &encryptedMetadataList,
+        const MatchSink &sink,
+        const CancellationToken &token);
+
+    /**
+     * @brief 释放陷门，并清除与其相关的匹配结果缓存
+     *
+     * 陷门与封装数据缓存的容量有界，长期未使用的条目也会按LRU被淘汰，效果与显式释放相同。
+     * @param trapdoor 陷门值
+     * @return 陷门是否存在并被释放
+     */
+    bool releaseTrapdoor(const std::string &trapdoor);
+
+    /**
+     * @brief 释放封装数据，并清除与其相关的匹配结果缓存
+     * @param encryptedMetadata 加密的元数据
+     * @return 封装数据是否存在并被释放
+     */
+    bool releaseEncapsulation(const std::string &encryptedMetadata);
+
+    /**
+     * @brief 设置共享任务调度器的工作线程数
+     * @param count 工作线程数，0表示批量操作在调用线程上串行执行
+     * @param reservedInteractive 只执行交互请求(资源分配、匹配验证)的线程数，默认取总数的1/4
+     * @return 实际生效的工作线程数
+     */
+    size_t setWorkerThreads(size_t count, size_t reservedInteractive = static_cast<size_t>(-1));
+
 private:
     // 隐藏实现细节
     class PrivateImpl;
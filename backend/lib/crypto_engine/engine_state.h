@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pairing_context.h"
+#include "compressed_gt.h"
+
+/**
+ * @brief 写时复制的分片映射表
+ *
+ * 映射表按键的哈希分为SHARDS个分片，每个分片是一个unordered_map，可由多个
+ * 快照版本共享。写者先复制整个快照(只复制分片指针)，修改某个键时再复制该键
+ * 所在的分片，其余分片继续与旧版本共享；同一版本内对同一分片的多次修改只复制
+ * 一次。已发布的快照不再被修改，读者无需加锁。
+ */
+template <typename V>
+class SnapshotMap
+{
+public:
+    typedef std::shared_ptr<const V> ValuePtr;
+
+    static const size_t SHARDS = 64;
+
+    typedef std::unordered_map<std::string, ValuePtr> Shard;
+
+    SnapshotMap()
+    {
+        for (auto &shard : shards_)
+        {
+            shard = std::make_shared<Shard>();
+        }
+        owned_.set();
+    }
+
+    // 复制后所有分片与原表共享，首次修改时才复制
+    SnapshotMap(const SnapshotMap &other) : shards_(other.shards_)
+    {
+    }
+
+    SnapshotMap &operator=(const SnapshotMap &other)
+    {
+        shards_ = other.shards_;
+        owned_.reset();
+        return *this;
+    }
+
+    /**
+     * @brief 查找键对应的值，不存在时返回空指针
+     */
+    ValuePtr find(const std::string &key) const
+    {
+        const Shard &shard = *shards_[shardOf(key)];
+        auto it = shard.find(key);
+        return it == shard.end() ? ValuePtr() : it->second;
+    }
+
+    /**
+     * @brief 写入键值(仅用于尚未发布的版本)
+     */
+    void set(const std::string &key, ValuePtr value)
+    {
+        mutableShard(shardOf(key))[key] = std::move(value);
+    }
+
+    /**
+     * @brief 删除键(仅用于尚未发布的版本)
+     * @return 键是否存在
+     */
+    bool erase(const std::string &key)
+    {
+        size_t index = shardOf(key);
+        if (shards_[index]->find(key) == shards_[index]->end())
+        {
+            return false;
+        }
+        mutableShard(index).erase(key);
+        return true;
+    }
+
+    /**
+     * @brief 第index个分片的全部条目(只读)
+     */
+    const Shard &shard(size_t index) const
+    {
+        return *shards_[index];
+    }
+
+    /**
+     * @brief 第index个分片是否与other共享，即两者从同一版本复制后都未修改该分片
+     */
+    bool sharesShard(const SnapshotMap &other, size_t index) const
+    {
+        return shards_[index] == other.shards_[index];
+    }
+
+    /**
+     * @brief 以新建的分片整体替换第index个分片(仅用于尚未发布的版本)
+     */
+    void replaceShard(size_t index, std::shared_ptr<Shard> shard)
+    {
+        shards_[index] = std::move(shard);
+        owned_.set(index);
+    }
+
+    /**
+     * @brief 条目总数
+     */
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const auto &shard : shards_)
+        {
+            total += shard->size();
+        }
+        return total;
+    }
+
+private:
+    static size_t shardOf(const std::string &key)
+    {
+        return std::hash<std::string>()(key) % SHARDS;
+    }
+
+    Shard &mutableShard(size_t index)
+    {
+        if (!owned_.test(index))
+        {
+            shards_[index] = std::make_shared<Shard>(*shards_[index]);
+            owned_.set(index);
+        }
+        return *shards_[index];
+    }
+
+    std::array<std::shared_ptr<Shard>, SHARDS> shards_;
+    std::bitset<SHARDS> owned_; // 本版本已独占(已复制)的分片
+};
+
+/**
+ * @brief 已注册节点的密钥材料(发布后不可变)
+ */
+struct NodeRecord
+{
+    G1 qi;      // 节点公钥 qi = H1(ID)
+    G1 si;      // 节点私钥 si = s*qi
+    Big xi;     // 随机值xi
+    G1 xiP;     // 群组公钥r的分量 xi*P
+    CompressedGT phiPart; // 群组公钥Φ的分量 e(qi, Ppub)，Φ为成员分量之积(压缩存储)
+
+    // 派生密钥模式下注册的节点不存储以上密钥材料，所有此类节点共享同一个derived为true的记录，
+    // 使用时由主密钥与节点密钥种子重新计算
+    bool derived = false;
+    uint64_t keyEpoch = 0; // 派生记录计算时的主密钥纪元，主密钥轮换后热缓存中的旧记录不再使用
+};
+
+struct GroupTreeNode;
+
+/**
+ * @brief 群组的成员与公钥(发布后不可变)
+ */
+struct GroupRecord
+{
+    std::vector<std::string> members;         // 成员节点ID列表(层次群组为空，成员在tree中)
+    std::shared_ptr<const GroupTreeNode> tree; // 层次群组的成员树，根节点缓存整体的部分和；平铺群组为空
+    G1 r;                                     // 群组公钥r部分
+    CompressedGT phi;                         // 群组公钥Phi部分(压缩存储)
+    uint64_t version;                         // 写入该记录时的状态版本号，成员或成员密钥变化时随之更新
+};
+
+/**
+ * @brief 引擎共享状态的一个不可变版本
+ *
+ * 读者通过原子加载取得当前版本的shared_ptr后即可无锁访问；写者在写锁内复制
+ * 当前版本、修改后原子地发布新版本。旧版本在最后一个读者释放后自动回收。
+ */
+struct EngineState
+{
+    bool initialized = false; // 是否已初始化
+    uint64_t version = 0;     // 状态版本号，每次发布递增
+
+    // 密码学参数
+    G1 P;    // 基点
+    G1 Ppub; // 系统公钥
+    Big s;   // 系统主密钥
+    uint64_t keyEpoch = 0; // 主密钥纪元，系统初始化时为1，每次轮换主密钥递增
+
+    // 派生密钥模式：新注册的节点不存储si与xi，xi = PRF(nodeKeySeed, qi)，使用时按需重新计算
+    bool derivedNodeKeys = false;
+    Big nodeKeySeed; // 派生xi的PRF密钥，系统初始化时随机选取
+
+    SnapshotMap<NodeRecord> nodes;                 // 节点ID -> 节点密钥材料
+    SnapshotMap<GroupRecord> groups;               // 群组ID -> 群组成员与公钥
+    SnapshotMap<std::set<std::string>> nodeGroups; // 节点ID -> 所属群组ID集合
+};
@@ -0,0 +1,374 @@
+#include "group_tree.h"
+#include "parallel_for.h"
+#include "point_accumulator.h"
+#include <algorithm>
+#include <unordered_set>
+
+using namespace std;
+
+const size_t GroupTreeNode::FANOUT;
+const size_t GroupTree::LEAF_CAPACITY;
+const size_t GroupTree::MAX_DEPTH;
+
+namespace
+{
+    typedef shared_ptr<const NodeRecord> KeyPtr;
+
+    // 成员在第depth层所在的子树：节点ID哈希的第depth个4位段
+    size_t routeOf(const string &nodeId, size_t depth)
+    {
+        uint64_t h = static_cast<uint64_t>(hash<string>()(nodeId));
+        return static_cast<size_t>((h >> (4 * depth)) & (GroupTreeNode::FANOUT - 1));
+    }
+
+    // 在路径上的节点中加入一个成员的分量
+    void addShare(GroupTreeNode &node, const NodeRecord &key, const Big &order)
+    {
+        if (node.memberCount == 0)
+        {
+            node.r = key.xiP;
+            node.qSum = key.qi;
+            node.phi = key.phiPart;
+            node.xiSum = key.xi % order;
+        }
+        else
+        {
+            node.r = node.r + key.xiP;
+            node.qSum = node.qSum + key.qi;
+            node.phi = CompressedGT(node.phi.value() * key.phiPart.value());
+            node.xiSum = (node.xiSum + key.xi) % order;
+        }
+        node.memberCount++;
+    }
+
+    // 在路径上的节点中减去一个成员的分量
+    void removeShare(GroupTreeNode &node, const NodeRecord &key, const Big &order)
+    {
+        node.memberCount--;
+        if (node.memberCount == 0)
+        {
+            node.r = G1();
+            node.qSum = G1();
+            node.phi = CompressedGT();
+            node.xiSum = 0;
+            return;
+        }
+        node.r = node.r + (-key.xiP);
+        node.qSum = node.qSum + (-key.qi);
+        node.phi = CompressedGT(node.phi.value() / key.phiPart.value());
+        node.xiSum = (node.xiSum + order - key.xi % order) % order;
+    }
+
+    // 由成员的分量(叶子)或子树的部分和(内部节点)计算节点缓存的部分和
+    void aggregate(GroupTreeNode &node, const vector<const G1 *> &rs, const vector<const G1 *> &qs,
+                   const vector<const CompressedGT *> &phis, const vector<const Big *> &xis, const Big &order)
+    {
+        vector<PointAccumulator> sums(2);
+        GT phi(1);
+        node.xiSum = 0;
+        for (size_t i = 0; i < rs.size(); i++)
+        {
+            sums[0].add(*rs[i]);
+            sums[1].add(*qs[i]);
+            phi = phi * phis[i]->value();
+            node.xiSum = (node.xiSum + *xis[i]) % order;
+        }
+        node.phi = CompressedGT(phi);
+
+        vector<G1> affine;
+        PointAccumulator::toAffineBatch(sums, affine);
+        node.r = affine[0];
+        node.qSum = affine[1];
+    }
+
+    shared_ptr<GroupTreeNode> makeLeaf(const vector<size_t> &indices, const vector<string> &members,
+                                       const vector<KeyPtr> &keys, const Big &order)
+    {
+        shared_ptr<GroupTreeNode> node = make_shared<GroupTreeNode>();
+        vector<const G1 *> rs, qs;
+        vector<const CompressedGT *> phis;
+        vector<const Big *> xis;
+        for (size_t i : indices)
+        {
+            node->members.push_back(members[i]);
+            rs.push_back(&keys[i]->xiP);
+            qs.push_back(&keys[i]->qi);
+            phis.push_back(&keys[i]->phiPart);
+            xis.push_back(&keys[i]->xi);
+        }
+        node->memberCount = indices.size();
+        aggregate(*node, rs, qs, phis, xis, order);
+        return node;
+    }
+
+    // 由已建好的子树组成内部节点
+    shared_ptr<GroupTreeNode> makeInternal(const array<GroupTree::NodePtr, GroupTreeNode::FANOUT> &children, const Big &order)
+    {
+        shared_ptr<GroupTreeNode> node = make_shared<GroupTreeNode>();
+        node->leaf = false;
+        node->children = children;
+        vector<const G1 *> rs, qs;
+        vector<const CompressedGT *> phis;
+        vector<const Big *> xis;
+        for (const auto &child : children)
+        {
+            if (!child)
+            {
+                continue;
+            }
+            node->memberCount += child->memberCount;
+            rs.push_back(&child->r);
+            qs.push_back(&child->qSum);
+            phis.push_back(&child->phi);
+            xis.push_back(&child->xiSum);
+        }
+        aggregate(*node, rs, qs, phis, xis, order);
+        return node;
+    }
+
+    void partition(const vector<size_t> &indices, const vector<string> &members, size_t depth,
+                   array<vector<size_t>, GroupTreeNode::FANOUT> &buckets)
+    {
+        for (size_t i : indices)
+        {
+            buckets[routeOf(members[i], depth)].push_back(i);
+        }
+    }
+
+    // 在当前线程上构建子树
+    GroupTree::NodePtr buildNode(const vector<size_t> &indices, size_t depth, const vector<string> &members,
+                                 const vector<KeyPtr> &keys, const Big &order)
+    {
+        if (indices.size() <= GroupTree::LEAF_CAPACITY || depth >= GroupTree::MAX_DEPTH)
+        {
+            return makeLeaf(indices, members, keys, order);
+        }
+
+        array<vector<size_t>, GroupTreeNode::FANOUT> buckets;
+        partition(indices, members, depth, buckets);
+        array<GroupTree::NodePtr, GroupTreeNode::FANOUT> children;
+        for (size_t c = 0; c < GroupTreeNode::FANOUT; c++)
+        {
+            if (!buckets[c].empty())
+            {
+                children[c] = buildNode(buckets[c], depth + 1, members, keys, order);
+            }
+        }
+        return makeInternal(children, order);
+    }
+
+    GroupTree::NodePtr rekeyNode(const GroupTree::NodePtr &node, const function<GT(const GT &)> &rekeyPhi)
+    {
+        shared_ptr<GroupTreeNode> copy = make_shared<GroupTreeNode>(*node);
+        copy->phi = CompressedGT(rekeyPhi(node->phi.value()));
+        for (auto &child : copy->children)
+        {
+            if (child)
+            {
+                child = rekeyNode(child, rekeyPhi);
+            }
+        }
+        return copy;
+    }
+
+    GroupTree::NodePtr insertAt(const GroupTree::NodePtr &node, size_t depth, const string &nodeId, const NodeRecord &key,
+                                const Big &order, const GroupTree::KeyResolver &keysOf)
+    {
+        shared_ptr<GroupTreeNode> copy = make_shared<GroupTreeNode>(*node);
+        if (!node->leaf)
+        {
+            size_t route = routeOf(nodeId, depth);
+            const GroupTree::NodePtr &child = node->children[route];
+            if (child)
+            {
+                copy->children[route] = insertAt(child, depth + 1, nodeId, key, order, keysOf);
+            }
+            else
+            {
+                shared_ptr<GroupTreeNode> leaf = make_shared<GroupTreeNode>();
+                leaf->members.push_back(nodeId);
+                addShare(*leaf, key, order);
+                copy->children[route] = leaf;
+            }
+            addShare(*copy, key, order);
+            return copy;
+        }
+
+        copy->members.push_back(nodeId);
+        addShare(*copy, key, order);
+        if (copy->members.size() <= GroupTree::LEAF_CAPACITY || depth >= GroupTree::MAX_DEPTH)
+        {
+            return copy;
+        }
+
+        // 叶子已满：取得叶内全部成员的密钥材料，按下一层哈希拆分；有成员取不到时保持为大叶子
+        vector<KeyPtr> keys(copy->members.size());
+        vector<size_t> indices(copy->members.size());
+        for (size_t i = 0; i < copy->members.size(); i++)
+        {
+            keys[i] = keysOf(copy->members[i]);
+            if (!keys[i])
+            {
+                return copy;
+            }
+            indices[i] = i;
+        }
+        return buildNode(indices, depth, copy->members, keys, order);
+    }
+
+    GroupTree::NodePtr eraseAt(const GroupTree::NodePtr &node, size_t depth, const string &nodeId, const NodeRecord &key,
+                               const Big &order)
+    {
+        shared_ptr<GroupTreeNode> copy = make_shared<GroupTreeNode>(*node);
+        removeShare(*copy, key, order);
+        if (node->leaf)
+        {
+            copy->members.erase(find(copy->members.begin(), copy->members.end(), nodeId));
+            return copy;
+        }
+
+        // 子树变空时摘除
+        size_t route = routeOf(nodeId, depth);
+        GroupTree::NodePtr child = eraseAt(node->children[route], depth + 1, nodeId, key, order);
+        copy->children[route] = child->memberCount > 0 ? child : GroupTree::NodePtr();
+        return copy;
+    }
+
+    GroupTree::NodePtr replaceAt(const GroupTree::NodePtr &node, size_t depth, const string &nodeId,
+                                 const NodeRecord &oldKey, const NodeRecord &newKey, const Big &order)
+    {
+        shared_ptr<GroupTreeNode> copy = make_shared<GroupTreeNode>(*node);
+        removeShare(*copy, oldKey, order);
+        addShare(*copy, newKey, order);
+        if (!node->leaf)
+        {
+            size_t route = routeOf(nodeId, depth);
+            copy->children[route] = replaceAt(node->children[route], depth + 1, nodeId, oldKey, newKey, order);
+        }
+        return copy;
+    }
+}
+
+GroupTree::NodePtr GroupTree::build(const vector<string> &members, const vector<KeyPtr> &keys,
+                                    const Big &order, const CancellationToken &token)
+{
+    // 去除重复的成员，保留首次出现的位置
+    vector<size_t> indices;
+    unordered_set<string> seen;
+    for (size_t i = 0; i < members.size(); i++)
+    {
+        if (seen.insert(members[i]).second)
+        {
+            indices.push_back(i);
+        }
+    }
+
+    if (indices.size() <= LEAF_CAPACITY)
+    {
+        return makeLeaf(indices, members, keys, order);
+    }
+
+    // 根的各个子树互不依赖，提交到调度器并行构建
+    array<vector<size_t>, GroupTreeNode::FANOUT> buckets;
+    partition(indices, members, 0, buckets);
+    array<NodePtr, GroupTreeNode::FANOUT> children;
+    parallelFor(GroupTreeNode::FANOUT, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end && !token.stopRequested(); c++)
+        {
+            if (!buckets[c].empty())
+            {
+                children[c] = buildNode(buckets[c], 1, members, keys, order);
+            }
+        }
+    });
+
+    if (token.stopRequested())
+    {
+        return NodePtr();
+    }
+    return makeInternal(children, order);
+}
+
+GroupTree::NodePtr GroupTree::insert(const NodePtr &root, const string &nodeId, const NodeRecord &key,
+                                     const Big &order, const KeyResolver &keysOf)
+{
+    if (contains(root, nodeId))
+    {
+        return root;
+    }
+    return insertAt(root, 0, nodeId, key, order, keysOf);
+}
+
+GroupTree::NodePtr GroupTree::erase(const NodePtr &root, const string &nodeId, const NodeRecord &key, const Big &order)
+{
+    if (!contains(root, nodeId))
+    {
+        return root;
+    }
+    return eraseAt(root, 0, nodeId, key, order);
+}
+
+GroupTree::NodePtr GroupTree::replace(const NodePtr &root, const string &nodeId, const NodeRecord &oldKey,
+                                      const NodeRecord &newKey, const Big &order)
+{
+    if (!contains(root, nodeId))
+    {
+        return root;
+    }
+    return replaceAt(root, 0, nodeId, oldKey, newKey, order);
+}
+
+GroupTree::NodePtr GroupTree::rekey(const NodePtr &root, const function<GT(const GT &)> &rekeyPhi)
+{
+    if (root->leaf)
+    {
+        return rekeyNode(root, rekeyPhi);
+    }
+
+    // 与构建相同，根的各个子树并行处理
+    shared_ptr<GroupTreeNode> copy = make_shared<GroupTreeNode>(*root);
+    copy->phi = CompressedGT(rekeyPhi(root->phi.value()));
+    parallelFor(GroupTreeNode::FANOUT, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t c = begin; c < end; c++)
+        {
+            if (copy->children[c])
+            {
+                copy->children[c] = rekeyNode(copy->children[c], rekeyPhi);
+            }
+        }
+    });
+    return copy;
+}
+
+bool GroupTree::contains(const NodePtr &root, const string &nodeId)
+{
+    const GroupTreeNode *node = root.get();
+    for (size_t depth = 0; node; depth++)
+    {
+        if (node->leaf)
+        {
+            return find(node->members.begin(), node->members.end(), nodeId) != node->members.end();
+        }
+        node = node->children[routeOf(nodeId, depth)].get();
+    }
+    return false;
+}
+
+void GroupTree::collectMembers(const NodePtr &root, vector<string> &out)
+{
+    if (!root)
+    {
+        return;
+    }
+    if (root->leaf)
+    {
+        out.insert(out.end(), root->members.begin(), root->members.end());
+        return;
+    }
+    for (const auto &child : root->children)
+    {
+        collectMembers(child, out);
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "engine_state.h"
+#include "cancellation.h"
+
+/**
+ * @brief 群组的组织方式
+ */
+enum class GroupLayout
+{
+    Flat,        // 成员列表与整体公钥(原有方式)
+    Hierarchical // 成员分布在层次树中，各子树缓存部分和
+};
+
+/**
+ * @brief 层次群组树的节点(发布后不可变)
+ *
+ * 每个节点缓存其子树全部成员的部分和：r = Σxi*P, qSum = Σqi, Φ = Πe(qi, Ppub)(压缩存储)
+ * 以及 xiSum = Σxi mod 群阶。叶子直接保存成员ID；内部节点最多FANOUT个子节点。
+ */
+struct GroupTreeNode
+{
+    static const size_t FANOUT = 16;
+
+    bool leaf = true;
+    size_t memberCount = 0;
+    std::vector<std::string> members;                                // 叶子的成员ID
+    std::array<std::shared_ptr<const GroupTreeNode>, FANOUT> children; // 内部节点的子树，可为空
+
+    G1 r;
+    G1 qSum;
+    CompressedGT phi;
+    Big xiSum;
+};
+
+/**
+ * @brief 层次群组树
+ *
+ * 成员按节点ID哈希的各个4位段逐层选择子树(哈希前缀树)，同一成员总落在同一条根到叶路径上，
+ * 因此加入与退出只复制这一条路径并在路径上增减该成员的分量，其余子树与旧版本共享。
+ * 叶子超过LEAF_CAPACITY个成员时按下一层哈希拆分。构建时根的各个子树并行计算。
+ */
+class GroupTree
+{
+public:
+    typedef std::shared_ptr<const GroupTreeNode> NodePtr;
+    typedef std::function<std::shared_ptr<const NodeRecord>(const std::string &nodeId)> KeyResolver;
+
+    static const size_t LEAF_CAPACITY = 64;
+    static const size_t MAX_DEPTH = 16; // 64位哈希按4位分段的层数，到达后叶子不再拆分
+
+    /**
+     * @brief 由成员及其密钥材料构建树，重复的成员只计一次
+     * @param members 成员ID
+     * @param keys 与members一一对应的密钥材料
+     * @param order 群阶(xiSum取模用)
+     * @param token 取消令牌，被取消时返回空指针
+     */
+    static NodePtr build(const std::vector<std::string> &members,
+                         const std::vector<std::shared_ptr<const NodeRecord>> &keys,
+                         const Big &order, const CancellationToken &token);
+
+    /**
+     * @brief 加入一个成员，返回新的根；成员已存在时返回原来的根
+     * @param keysOf 叶子拆分时取得叶内其余成员的密钥材料
+     */
+    static NodePtr insert(const NodePtr &root, const std::string &nodeId, const NodeRecord &key,
+                          const Big &order, const KeyResolver &keysOf);
+
+    /**
+     * @brief 移除一个成员，返回新的根；成员不存在时返回原来的根
+     */
+    static NodePtr erase(const NodePtr &root, const std::string &nodeId, const NodeRecord &key, const Big &order);
+
+    /**
+     * @brief 以成员的新密钥材料替换旧分量(节点重新注册时使用)，返回新的根；成员不存在时返回原来的根
+     * @param oldKey 成员当前计入树中的密钥材料
+     * @param newKey 替换后的密钥材料
+     */
+    static NodePtr replace(const NodePtr &root, const std::string &nodeId, const NodeRecord &oldKey,
+                           const NodeRecord &newKey, const Big &order);
+
+    /**
+     * @brief 复制整棵树并以rekeyPhi变换各节点缓存的Φ，其余部分和不变(主密钥轮换时使用)
+     * @param rekeyPhi 可能在多个工作线程上并发调用
+     */
+    static NodePtr rekey(const NodePtr &root, const std::function<GT(const GT &phi)> &rekeyPhi);
+
+    /**
+     * @brief 成员是否在树中
+     */
+    static bool contains(const NodePtr &root, const std::string &nodeId);
+
+    /**
+     * @brief 列出全部成员
+     */
+    static void collectMembers(const NodePtr &root, std::vector<std::string> &out);
+};
@@ -13,6 +13,8 @@ try {
     }
 }
 
+const VerifyCoalescer = require("./verify_coalescer");
+
 /**
  * MIRACL加密引擎的JavaScript包装器
  * 提供基于属性的加密和搜索功能
@@ -21,17 +23,31 @@ class CryptoEngineWrapper {
     constructor() {
         this.engine = new CryptoEngine();
         this.initialized = false;
+        this.verifyCoalescer = null;
     }
 
     /**
      * 初始化加密系统
+     * @param {Object} [options]
+     * @param {number} [options.securityLevel] 安全级别，默认128
+     * @param {number} [options.nodeTag] 唯一ID的16位节点标记(0~65535)，多实例部署时每个后端进程应不同；
+     *                                  未指定时读取环境变量CRYPTO_ENGINE_NODE_TAG，仍未设置则随机选取
      * @returns {boolean} 初始化是否成功
      */
-    async initialize() {
+    async initialize(options = {}) {
         if (this.initialized) return true;
 
+        const securityLevel = options.securityLevel === undefined ? 128 : options.securityLevel;
+        let nodeTag = options.nodeTag;
+        if (nodeTag === undefined && process.env.CRYPTO_ENGINE_NODE_TAG !== undefined) {
+            nodeTag = Number(process.env.CRYPTO_ENGINE_NODE_TAG);
+        }
+        if (nodeTag !== undefined && (!Number.isInteger(nodeTag) || nodeTag < 0 || nodeTag > 65535)) {
+            throw new Error("节点标记必须是0到65535之间的整数");
+        }
+
         try {
-            const result = this.engine.initialize();
+            const result = this.engine.systemSetup(securityLevel, nodeTag === undefined ? undefined : { nodeTag });
             this.initialized = result;
             return result;
         } catch (error) {
@@ -40,6 +56,25 @@ class CryptoEngineWrapper {
         }
     }
 
+    /**
+     * 轮换系统主密钥：在后台并行重算全部节点私钥与群组公钥，完成后原子切换到新的密钥纪元，期间其他请求照常处理
+     * 切换前发出的陷门仍可匹配旧纪元的加密元数据；切换后生成的陷门只匹配此后封装的加密元数据
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @returns {{epoch: number, status: string}} 新的密钥纪元(未完成时为0)与结束状态
+     */
+    async rotateMasterKey(options) {
+        if (!this.initialized) await this.initialize();
+
+        try {
+            return await this.engine.rotateMasterKeyAsync(options);
+        } catch (error) {
+            console.error("主密钥轮换失败:", error);
+            throw new Error(`主密钥轮换失败: ${error.message}`);
+        }
+    }
+
     /**
      * 注册新节点
      * @param {string} nodeId 节点ID
@@ -60,6 +95,117 @@ class CryptoEngineWrapper {
         }
     }
 
+    /**
+     * 批量注册节点
+     * @param {string[]} nodeIds 节点ID数组
+     * @returns {Object[]} 与输入一一对应的 {nodeId, key} 数组
+     */
+    async registerNodes(nodeIds) {
+        if (!this.initialized) await this.initialize();
+
+        if (!Array.isArray(nodeIds) || nodeIds.length === 0) {
+            throw new Error("节点ID必须是非空数组");
+        }
+
+        try {
+            return this.engine.nodeRegistrationBatch(nodeIds);
+        } catch (error) {
+            console.error("批量注册节点失败:", error);
+            throw new Error(`批量注册节点失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 设置引擎工作线程数，所有批量操作共用这组线程
+     * @param {number} count 工作线程数，0表示在调用线程上串行执行
+     * @param {number} [reservedInteractive] 只处理资源分配、匹配验证等交互请求的线程数，默认取总数的1/4
+     * @returns {number} 实际生效的工作线程数
+     */
+    async setWorkerThreads(count, reservedInteractive) {
+        if (!Number.isInteger(count) || count < 0) {
+            throw new Error("工作线程数必须是非负整数");
+        }
+
+        if (reservedInteractive !== undefined && (!Number.isInteger(reservedInteractive) || reservedInteractive < 0)) {
+            throw new Error("预留线程数必须是非负整数");
+        }
+
+        try {
+            return reservedInteractive === undefined
+                ? this.engine.setWorkerThreads(count)
+                : this.engine.setWorkerThreads(count, reservedInteractive);
+        } catch (error) {
+            console.error("设置工作线程数失败:", error);
+            throw new Error(`设置工作线程数失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 设置匹配后在候选节点中选择目标节点的策略
+     * @param {string} policy "first_match"(默认)、"least_loaded"、"weighted_round_robin"或"bin_packing"
+     * @returns {string} 生效的策略
+     */
+    async setAllocationPolicy(policy) {
+        if (typeof policy !== "string") {
+            throw new Error("分配策略必须是字符串");
+        }
+
+        try {
+            return this.engine.setAllocationPolicy(policy);
+        } catch (error) {
+            console.error("设置分配策略失败:", error);
+            throw new Error(`设置分配策略失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 切换派生密钥模式：此后注册的节点不再常驻si与xi，使用时按需重新计算并保存在有界热缓存中
+     * 适用于节点数量很大、每次只有少部分节点参与建组与陷门生成的场景；已注册的节点不受影响
+     * @param {boolean} enabled 是否开启
+     * @param {number} [cacheCapacity] 热缓存最多保存的节点数
+     * @returns {boolean} 当前是否处于派生密钥模式
+     */
+    async setDerivedNodeKeys(enabled, cacheCapacity) {
+        if (typeof enabled !== "boolean") {
+            throw new Error("派生密钥模式开关必须是布尔值");
+        }
+
+        if (cacheCapacity !== undefined && (!Number.isInteger(cacheCapacity) || cacheCapacity <= 0)) {
+            throw new Error("热缓存容量必须是正整数");
+        }
+
+        try {
+            return cacheCapacity === undefined
+                ? this.engine.setDerivedNodeKeys(enabled)
+                : this.engine.setDerivedNodeKeys(enabled, cacheCapacity);
+        } catch (error) {
+            console.error("设置派生密钥模式失败:", error);
+            throw new Error(`设置派生密钥模式失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 上报节点负载，供负载相关的分配策略使用
+     * @param {{nodeId: string, load: number, capacity: number, weight?: number}[]} loads 各节点的负载信息
+     */
+    async updateNodeLoads(loads) {
+        if (!Array.isArray(loads)) {
+            throw new Error("节点负载必须是数组");
+        }
+
+        try {
+            this.engine.updateNodeLoads(
+                loads.map((entry) => entry.nodeId),
+                loads.map((entry) => entry.load),
+                loads.map((entry) => entry.capacity),
+                loads.map((entry) => (entry.weight === undefined ? 1 : entry.weight))
+            );
+        } catch (error) {
+            console.error("更新节点负载失败:", error);
+            throw new Error(`更新节点负载失败: ${error.message}`);
+        }
+    }
+
     /**
      * 创建新群组
      * @param {string} groupName 群组名称
@@ -85,6 +231,74 @@ class CryptoEngineWrapper {
         }
     }
 
+    /**
+     * 向群组加入成员，群组公钥按新成员的分量增量更新，不重新计算整个群组
+     * @param {string} groupId 群组ID
+     * @param {string[]} nodeIds 加入的节点ID(已是成员的忽略)
+     * @returns {boolean} 是否成功
+     */
+    async groupAddMembers(groupId, nodeIds) {
+        if (!this.initialized) await this.initialize();
+
+        if (!groupId || typeof groupId !== "string" || !Array.isArray(nodeIds)) {
+            throw new Error("群组ID必须是非空字符串，节点ID必须是数组");
+        }
+
+        try {
+            return this.engine.groupAddMembers(groupId, nodeIds);
+        } catch (error) {
+            console.error(`群组 ${groupId} 加入成员失败:`, error);
+            throw new Error(`群组加入成员失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 从群组移除成员，群组公钥按成员的分量增量更新；不允许移除全部成员
+     * @param {string} groupId 群组ID
+     * @param {string[]} nodeIds 移除的节点ID(不是成员的忽略)
+     * @returns {boolean} 是否成功
+     */
+    async groupRemoveMembers(groupId, nodeIds) {
+        if (!this.initialized) await this.initialize();
+
+        if (!groupId || typeof groupId !== "string" || !Array.isArray(nodeIds)) {
+            throw new Error("群组ID必须是非空字符串，节点ID必须是数组");
+        }
+
+        try {
+            return this.engine.groupRemoveMembers(groupId, nodeIds);
+        } catch (error) {
+            console.error(`群组 ${groupId} 移除成员失败:`, error);
+            throw new Error(`群组移除成员失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 登记群组的关键词词表：在后台预先求出各关键词的H2(GroupID||keyword)，之后的陷门生成与封装直接使用
+     * 结果保存在容量有界的缓存中；群组成员变化或主密钥轮换后GT底数在下次使用时重算
+     * @param {string} groupId 群组ID
+     * @param {string[]} keywords 关键词列表
+     * @param {Object} [options]
+     * @param {boolean} [options.precomputeBases] 同时求出封装用的GT底数并建立定基幂预计算表
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @returns {{prepared: number, status: string}} 已完成预计算的关键词数与结束状态
+     */
+    async registerGroupVocabulary(groupId, keywords, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!groupId || typeof groupId !== "string" || !Array.isArray(keywords)) {
+            throw new Error("群组ID必须是非空字符串，关键词必须是数组");
+        }
+
+        try {
+            return await this.engine.registerGroupVocabularyAsync(groupId, keywords, options);
+        } catch (error) {
+            console.error(`群组 ${groupId} 词表预计算失败:`, error);
+            throw new Error(`群组词表预计算失败: ${error.message}`);
+        }
+    }
+
     /**
      * 获取所有已注册节点
      * @returns {Object} 节点ID到私钥的映射
@@ -165,6 +379,62 @@ class CryptoEngineWrapper {
         }
     }
 
+    /**
+     * 封装一条带多个关键词的记录
+     * 所有关键词共享一次随机数与X，任一关键词的陷门都与该记录匹配
+     * @param {string[]} keywords 记录的关键词数组
+     * @param {string} groupId 群组ID
+     * @returns {string} 封装后的数据
+     */
+    async encapsulateRecordKeywords(keywords, groupId) {
+        if (!this.initialized) await this.initialize();
+
+        if (!Array.isArray(keywords) || keywords.length === 0) {
+            throw new Error("关键词必须是非空数组");
+        }
+
+        if (!groupId || typeof groupId !== "string") {
+            throw new Error("群组ID必须是非空字符串");
+        }
+
+        try {
+            return this.engine.encapsulateRecordKeywords(keywords, groupId);
+        } catch (error) {
+            console.error(`多关键词封装失败:`, error);
+            throw new Error(`多关键词封装失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 批量封装关键词(后台导入使用)
+     * 以批量优先级执行，不占用为资源分配预留的线程
+     * @param {string[]} keywords 关键词数组
+     * @param {string} groupId 群组ID
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号，中止后放弃剩余的关键词
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @returns {{encapsulations: (string|null)[], status: string}} 与输入一一对应的封装结果(失败为空字符串，
+     *     未处理为null)与结束状态("completed"/"cancelled"/"deadline_exceeded")
+     */
+    async encapsulateKeywords(keywords, groupId, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!Array.isArray(keywords) || keywords.length === 0) {
+            throw new Error("关键词必须是非空数组");
+        }
+
+        if (!groupId || typeof groupId !== "string") {
+            throw new Error("群组ID必须是非空字符串");
+        }
+
+        try {
+            return await this.engine.encapsulateKeywordBatchAsync(keywords, groupId, options);
+        } catch (error) {
+            console.error(`批量封装关键词失败:`, error);
+            throw new Error(`批量封装关键词失败: ${error.message}`);
+        }
+    }
+
     /**
      * 为指定群组生成搜索令牌
      * @param {string} groupName 群组名称
@@ -190,6 +460,288 @@ class CryptoEngineWrapper {
         }
     }
 
+    /**
+     * 验证陷门与加密元数据是否匹配
+     * 启用合并后，并发到达的单条请求会被合并为批量验证
+     * @param {string} trapdoor 陷门
+     * @param {string} encryptedMetadata 加密元数据
+     * @returns {boolean} 是否匹配
+     */
+    async verifyKeywordMatch(trapdoor, encryptedMetadata) {
+        if (!this.initialized) await this.initialize();
+
+        if (!trapdoor || typeof trapdoor !== "string") {
+            throw new Error("陷门必须是非空字符串");
+        }
+
+        if (!encryptedMetadata || typeof encryptedMetadata !== "string") {
+            throw new Error("加密元数据必须是非空字符串");
+        }
+
+        try {
+            if (this.verifyCoalescer) {
+                return await this.verifyCoalescer.verify(trapdoor, encryptedMetadata);
+            }
+            return this.engine.verifyKeywordMatch(trapdoor, encryptedMetadata);
+        } catch (error) {
+            console.error(`验证关键词匹配失败:`, error);
+            throw new Error(`验证关键词匹配失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 批量验证关键词匹配
+     * @param {string[]} trapdoors 陷门数组
+     * @param {string[]} encryptedMetadataList 加密元数据数组，与陷门一一对应
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号，中止后放弃剩余的验证
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @returns {{results: (boolean|null)[], status: string}} 与输入一一对应的匹配结果(未验证为null)与结束状态
+     */
+    async verifyKeywordMatchBatch(trapdoors, encryptedMetadataList, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!Array.isArray(trapdoors) || !Array.isArray(encryptedMetadataList)) {
+            throw new Error("陷门与加密元数据必须是数组");
+        }
+
+        if (trapdoors.length !== encryptedMetadataList.length) {
+            throw new Error("陷门与加密元数据数量必须一致");
+        }
+
+        try {
+            return await this.engine.verifyKeywordMatchBatchAsync(trapdoors, encryptedMetadataList, options);
+        } catch (error) {
+            console.error(`批量验证关键词匹配失败:`, error);
+            throw new Error(`批量验证关键词匹配失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 根据关键词匹配结果分配边缘节点
+     * 在匹配的节点中按setAllocationPolicy设置的策略选择目标节点
+     * 客户端断开或超时后可通过signal中止，引擎放弃剩余的匹配检查
+     * @param {string} trapdoor 陷门
+     * @param {string[]} encryptedMetadataList 加密元数据数组
+     * @param {string[]} edgeNodeIds 与加密元数据一一对应的边缘节点ID数组
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @param {number} [options.demand=1] 本次分配的需求量，选中的节点立即记入该负载
+     * @returns {{nodeId: string, evaluated: number, status: string}} 分配的节点(没有匹配时为空字符串)、
+     *     已检查的元数据数与结束状态
+     */
+    async allocateResources(trapdoor, encryptedMetadataList, edgeNodeIds, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!trapdoor || typeof trapdoor !== "string") {
+            throw new Error("陷门必须是非空字符串");
+        }
+
+        if (!Array.isArray(encryptedMetadataList) || !Array.isArray(edgeNodeIds)) {
+            throw new Error("加密元数据与边缘节点ID必须是数组");
+        }
+
+        try {
+            return await this.engine.allocateResourcesAsync(trapdoor, encryptedMetadataList, edgeNodeIds, options);
+        } catch (error) {
+            console.error(`资源分配失败:`, error);
+            throw new Error(`资源分配失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 按当前分配策略返回排名前k的匹配节点
+     * 首选节点拒绝任务时可依次尝试后续节点，无需重新匹配
+     * @param {string} trapdoor 陷门
+     * @param {string[]} encryptedMetadataList 加密元数据数组
+     * @param {string[]} edgeNodeIds 与加密元数据一一对应的边缘节点ID数组
+     * @param {number} k 最多返回的节点数
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @param {number} [options.demand=1] 需求量，只记入排名第一的节点
+     * @returns {{nodeIds: string[], evaluated: number, status: string}} 排序后的节点、已检查数与结束状态
+     */
+    async allocateResourcesTopK(trapdoor, encryptedMetadataList, edgeNodeIds, k, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!trapdoor || typeof trapdoor !== "string") {
+            throw new Error("陷门必须是非空字符串");
+        }
+
+        if (!Array.isArray(encryptedMetadataList) || !Array.isArray(edgeNodeIds)) {
+            throw new Error("加密元数据与边缘节点ID必须是数组");
+        }
+
+        if (!Number.isInteger(k) || k < 1) {
+            throw new Error("k必须是正整数");
+        }
+
+        try {
+            return await this.engine.allocateResourcesTopKAsync(
+                trapdoor,
+                encryptedMetadataList,
+                edgeNodeIds,
+                k,
+                options
+            );
+        } catch (error) {
+            console.error(`资源分配失败:`, error);
+            throw new Error(`资源分配失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 多关键词查询：对每条记录求陷门的AND/OR组合，AND遇到不匹配、OR遇到匹配后跳过其余陷门
+     * @param {string|Object} query 陷门字符串，或{and: [...]}/{or: [...]}，数组元素可继续嵌套
+     * @param {string[]} encryptedMetadataList 加密元数据数组
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @returns {{results: Array<boolean|null>, pairings: number, status: string}} 与记录一一对应的结果(未检查的为null)、
+     *     实际执行的配对次数与结束状态
+     */
+    async matchKeywordQuery(query, encryptedMetadataList, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!Array.isArray(encryptedMetadataList)) {
+            throw new Error("加密元数据必须是数组");
+        }
+
+        try {
+            return await this.engine.matchKeywordQueryAsync(query, encryptedMetadataList, options);
+        } catch (error) {
+            console.error(`多关键词查询失败:`, error);
+            throw new Error(`多关键词查询失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 按多关键词查询分配资源，例如{and: [gpu陷门, ssd陷门]}要求节点同时具备两项能力
+     * @param {string|Object} query 查询表达式，格式同matchKeywordQuery
+     * @param {string[]} encryptedMetadataList 加密元数据数组
+     * @param {string[]} edgeNodeIds 与加密元数据一一对应的边缘节点ID数组
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @param {number} [options.demand=1] 本次分配的需求量
+     * @returns {{nodeId: string, evaluated: number, status: string}} 分配的节点ID(没有匹配时为空字符串)、已检查的记录数与结束状态
+     */
+    async allocateResourcesByQuery(query, encryptedMetadataList, edgeNodeIds, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!Array.isArray(encryptedMetadataList) || !Array.isArray(edgeNodeIds)) {
+            throw new Error("加密元数据与边缘节点ID必须是数组");
+        }
+
+        try {
+            return await this.engine.allocateResourcesByQueryAsync(query, encryptedMetadataList, edgeNodeIds, options);
+        } catch (error) {
+            console.error(`资源分配失败:`, error);
+            throw new Error(`资源分配失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 一轮批量分配：多个请求(各自的陷门)对同一组候选记录匹配，每个请求分配一个节点
+     * 各请求按顺序分配，前面请求的分配结果计入节点负载
+     * @param {string[]} trapdoors 各请求的陷门
+     * @param {string[]} encryptedMetadataList 加密元数据数组
+     * @param {string[]} edgeNodeIds 与加密元数据一一对应的边缘节点ID数组
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @param {number} [options.demand=1] 每个请求的需求量
+     * @returns {{nodeIds: string[], complete: boolean[], status: string}} 与请求一一对应的分配节点(没有匹配时为空字符串)、
+     *     各请求是否检查了全部记录与结束状态
+     */
+    async allocateResourcesBatch(trapdoors, encryptedMetadataList, edgeNodeIds, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!Array.isArray(trapdoors) || !Array.isArray(encryptedMetadataList) || !Array.isArray(edgeNodeIds)) {
+            throw new Error("陷门、加密元数据与边缘节点ID必须是数组");
+        }
+
+        try {
+            return await this.engine.allocateResourcesBatchAsync(
+                trapdoors,
+                encryptedMetadataList,
+                edgeNodeIds,
+                options
+            );
+        } catch (error) {
+            console.error(`批量资源分配失败:`, error);
+            throw new Error(`批量资源分配失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 流式资源分配：匹配的边缘节点按块回调，不等待全部加密元数据检查完成
+     * 回调消费不及时时引擎暂停匹配；回调返回false可提前结束扫描
+     * @param {string} trapdoor 陷门
+     * @param {string[]} encryptedMetadataList 加密元数据数组
+     * @param {string[]} edgeNodeIds 与加密元数据一一对应的边缘节点ID数组
+     * @param {function({indices: number[], nodeIds: string[]}): (boolean|void)} onChunk 每块匹配结果的回调，
+     *     各块按加密元数据的顺序回调
+     * @param {Object} [options]
+     * @param {AbortSignal} [options.signal] 中止信号
+     * @param {number} [options.timeoutMs] 超时时间(毫秒)
+     * @param {number} [options.maxPendingChunks=4] 等待回调处理的最大块数
+     * @returns {{matched: number, evaluated: number, status: string}} 实际交给回调的匹配数、已检查数与结束状态
+     */
+    async allocateResourcesStream(trapdoor, encryptedMetadataList, edgeNodeIds, onChunk, options) {
+        if (!this.initialized) await this.initialize();
+
+        if (!trapdoor || typeof trapdoor !== "string") {
+            throw new Error("陷门必须是非空字符串");
+        }
+
+        if (!Array.isArray(encryptedMetadataList) || !Array.isArray(edgeNodeIds)) {
+            throw new Error("加密元数据与边缘节点ID必须是数组");
+        }
+
+        if (typeof onChunk !== "function") {
+            throw new Error("回调必须是函数");
+        }
+
+        try {
+            return await this.engine.allocateResourcesStream(
+                trapdoor,
+                encryptedMetadataList,
+                edgeNodeIds,
+                onChunk,
+                options
+            );
+        } catch (error) {
+            console.error(`流式资源分配失败:`, error);
+            throw new Error(`流式资源分配失败: ${error.message}`);
+        }
+    }
+
+    /**
+     * 启用单条验证请求的微批合并
+     * @param {Object} [options]
+     * @param {number} [options.windowMs=2] 收集窗口(毫秒)
+     * @param {number} [options.maxBatchSize=256] 单批最多合并的请求数
+     */
+    enableVerifyCoalescing(options = {}) {
+        if (this.verifyCoalescer) {
+            this.verifyCoalescer.flush();
+        }
+        this.verifyCoalescer = new VerifyCoalescer(this.engine, options);
+    }
+
+    /**
+     * 关闭微批合并，已收集的请求立即提交
+     */
+    disableVerifyCoalescing() {
+        if (this.verifyCoalescer) {
+            this.verifyCoalescer.flush();
+            this.verifyCoalescer = null;
+        }
+    }
+
     /**
      * 使用搜索令牌在加密数据中搜索
      * @param {string} searchToken 搜索令牌
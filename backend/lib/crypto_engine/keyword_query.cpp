@@ -0,0 +1,144 @@
+#include "keyword_query.h"
+#include <algorithm>
+
+using namespace std;
+
+const size_t KeywordQuery::NPOS;
+
+size_t KeywordQuery::addTerm(size_t term)
+{
+    Node node;
+    node.op = Op::Term;
+    node.term = term;
+    nodes_.push_back(node);
+    termCount_ = max(termCount_, term + 1);
+    return nodes_.size() - 1;
+}
+
+size_t KeywordQuery::addAnd(const vector<size_t> &children)
+{
+    return addGroup(Op::And, children);
+}
+
+size_t KeywordQuery::addOr(const vector<size_t> &children)
+{
+    return addGroup(Op::Or, children);
+}
+
+size_t KeywordQuery::addGroup(Op op, const vector<size_t> &children)
+{
+    Node node;
+    node.op = op;
+    node.term = NPOS;
+    node.children = children;
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+}
+
+bool KeywordQuery::valid() const
+{
+    if (root_ >= nodes_.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < nodes_.size(); i++)
+    {
+        if (nodes_[i].op == Op::Term)
+        {
+            continue;
+        }
+        if (nodes_[i].children.empty())
+        {
+            return false;
+        }
+        // 子节点必须先于父节点添加，保证没有环
+        for (size_t child : nodes_[i].children)
+        {
+            if (child >= i)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+QueryPlanner::QueryPlanner(const KeywordQuery &query)
+    : query_(query),
+      evaluations_(new atomic<uint64_t>[query.termCount()]),
+      matches_(new atomic<uint64_t>[query.termCount()])
+{
+    for (size_t i = 0; i < query.termCount(); i++)
+    {
+        evaluations_[i].store(0);
+        matches_[i].store(0);
+    }
+}
+
+void QueryPlanner::record(size_t term, bool matched)
+{
+    evaluations_[term].fetch_add(1, memory_order_relaxed);
+    if (matched)
+    {
+        matches_[term].fetch_add(1, memory_order_relaxed);
+    }
+}
+
+QueryPlanner::Plan QueryPlanner::plan() const
+{
+    // 子节点编号小于父节点，按编号顺序即可自底向上估计各节点的匹配概率
+    size_t count = query_.nodeCount();
+    vector<double> probability(count);
+    Plan order(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const KeywordQuery::Node &node = query_.node(i);
+        if (node.op == KeywordQuery::Op::Term)
+        {
+            double evaluations = static_cast<double>(evaluations_[node.term].load(memory_order_relaxed));
+            double matches = static_cast<double>(matches_[node.term].load(memory_order_relaxed));
+            probability[i] = (matches + 1.0) / (evaluations + 2.0);
+            continue;
+        }
+
+        order[i] = node.children;
+        bool isAnd = node.op == KeywordQuery::Op::And;
+        stable_sort(order[i].begin(), order[i].end(), [&](size_t a, size_t b)
+        {
+            return isAnd ? probability[a] < probability[b] : probability[a] > probability[b];
+        });
+
+        double combined = 1.0;
+        for (size_t child : node.children)
+        {
+            combined *= isAnd ? probability[child] : 1.0 - probability[child];
+        }
+        probability[i] = isAnd ? combined : 1.0 - combined;
+    }
+    return order;
+}
+
+bool QueryPlanner::evaluate(const Plan &plan, const function<bool(size_t term)> &termMatches) const
+{
+    return evaluateNode(query_.root(), plan, termMatches);
+}
+
+bool QueryPlanner::evaluateNode(size_t index, const Plan &plan, const function<bool(size_t term)> &termMatches) const
+{
+    const KeywordQuery::Node &node = query_.node(index);
+    if (node.op == KeywordQuery::Op::Term)
+    {
+        return termMatches(node.term);
+    }
+
+    // AND遇到不匹配、OR遇到匹配时立即返回，跳过其余子节点的配对运算
+    bool isAnd = node.op == KeywordQuery::Op::And;
+    for (size_t child : plan[index])
+    {
+        if (evaluateNode(child, plan, termMatches) != isAnd)
+        {
+            return !isAnd;
+        }
+    }
+    return isAnd;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 多关键词布尔查询
+ *
+ * 查询是由陷门项(Term)与AND/OR组合构成的表达式树。节点自底向上添加，
+ * 子节点的编号总小于父节点；陷门项以陷门在调用方陷门列表中的下标表示。
+ */
+class KeywordQuery
+{
+public:
+    enum class Op
+    {
+        Term, // 单个陷门
+        And,  // 所有子节点都匹配
+        Or    // 任一子节点匹配
+    };
+
+    struct Node
+    {
+        Op op;
+        size_t term;                  // Term节点的陷门下标
+        std::vector<size_t> children; // And/Or节点的子节点编号
+    };
+
+    static const size_t NPOS = static_cast<size_t>(-1);
+
+    KeywordQuery() : root_(NPOS), termCount_(0) {}
+
+    /**
+     * @brief 添加陷门项，返回节点编号
+     */
+    size_t addTerm(size_t term);
+
+    /**
+     * @brief 添加AND节点，子节点必须已添加
+     */
+    size_t addAnd(const std::vector<size_t> &children);
+
+    /**
+     * @brief 添加OR节点，子节点必须已添加
+     */
+    size_t addOr(const std::vector<size_t> &children);
+
+    /**
+     * @brief 设置根节点
+     */
+    void setRoot(size_t node) { root_ = node; }
+
+    size_t root() const { return root_; }
+    const Node &node(size_t index) const { return nodes_[index]; }
+    size_t nodeCount() const { return nodes_.size(); }
+
+    /**
+     * @brief 引用的陷门下标上界(最大下标加1)
+     */
+    size_t termCount() const { return termCount_; }
+
+    /**
+     * @brief 查询是否完整(有根节点，组合节点都有子节点)
+     */
+    bool valid() const;
+
+private:
+    size_t addGroup(Op op, const std::vector<size_t> &children);
+
+    std::vector<Node> nodes_;
+    size_t root_;
+    size_t termCount_;
+};
+
+/**
+ * @brief 查询计划器：按估计的选择率安排子节点的求值顺序
+ *
+ * 记录每个陷门项实际求值的次数与匹配次数，以(匹配+1)/(求值+2)估计匹配概率；
+ * AND节点的匹配概率为子节点概率之积，OR节点为1-Π(1-p)。AND节点先求值最可能
+ * 不匹配的子节点，OR节点先求值最可能匹配的子节点，使短路尽早发生。
+ * record可在多个线程上并发调用。
+ */
+class QueryPlanner
+{
+public:
+    typedef std::vector<std::vector<size_t>> Plan; // 各节点子节点的求值顺序
+
+    explicit QueryPlanner(const KeywordQuery &query);
+
+    /**
+     * @brief 记录一次陷门项的求值结果
+     */
+    void record(size_t term, bool matched);
+
+    /**
+     * @brief 按当前统计生成求值顺序
+     */
+    Plan plan() const;
+
+    /**
+     * @brief 按给定顺序短路求值
+     * @param plan plan()的返回值
+     * @param termMatches 求陷门项是否匹配(只对必须求值的项调用)
+     */
+    bool evaluate(const Plan &plan, const std::function<bool(size_t term)> &termMatches) const;
+
+private:
+    bool evaluateNode(size_t index, const Plan &plan, const std::function<bool(size_t term)> &termMatches) const;
+
+    const KeywordQuery &query_;
+    std::unique_ptr<std::atomic<uint64_t>[]> evaluations_;
+    std::unique_ptr<std::atomic<uint64_t>[]> matches_;
+};
@@ -0,0 +1,180 @@
+#include "match_cache.h"
+
+using namespace std;
+
+MatchResultCache::MatchResultCache(size_t capacity) : capacity_(capacity > 0 ? capacity : 1)
+{
+}
+
+bool MatchResultCache::lookup(const UniqueId &trapdoorId, const UniqueId &encId, bool &matched)
+{
+    auto it = index_.find(make_pair(trapdoorId, encId));
+    if (it == index_.end())
+    {
+        return false;
+    }
+
+    // 命中后移到表头
+    entries_.splice(entries_.begin(), entries_, it->second);
+    matched = it->second->matched;
+    return true;
+}
+
+void MatchResultCache::insert(const UniqueId &trapdoorId, const UniqueId &encId, bool matched)
+{
+    Key key = make_pair(trapdoorId, encId);
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+        it->second->matched = matched;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    // 超出容量时淘汰表尾
+    while (entries_.size() >= capacity_)
+    {
+        eraseEntry(prev(entries_.end()));
+    }
+
+    entries_.push_front(Entry{key, matched});
+    index_[key] = entries_.begin();
+    byTrapdoor_[trapdoorId].insert(encId);
+    byEnc_[encId].insert(trapdoorId);
+}
+
+void MatchResultCache::eraseTrapdoor(const UniqueId &trapdoorId)
+{
+    auto it = byTrapdoor_.find(trapdoorId);
+    if (it == byTrapdoor_.end())
+    {
+        return;
+    }
+
+    // 先取出集合再逐个删除，避免eraseEntry修改正在遍历的集合
+    unordered_set<UniqueId, UniqueIdHash> encIds;
+    encIds.swap(it->second);
+    for (const auto &encId : encIds)
+    {
+        auto entryIt = index_.find(make_pair(trapdoorId, encId));
+        if (entryIt != index_.end())
+        {
+            eraseEntry(entryIt->second);
+        }
+    }
+    byTrapdoor_.erase(trapdoorId);
+}
+
+void MatchResultCache::eraseEncapsulation(const UniqueId &encId)
+{
+    auto it = byEnc_.find(encId);
+    if (it == byEnc_.end())
+    {
+        return;
+    }
+
+    unordered_set<UniqueId, UniqueIdHash> trapdoorIds;
+    trapdoorIds.swap(it->second);
+    for (const auto &trapdoorId : trapdoorIds)
+    {
+        auto entryIt = index_.find(make_pair(trapdoorId, encId));
+        if (entryIt != index_.end())
+        {
+            eraseEntry(entryIt->second);
+        }
+    }
+    byEnc_.erase(encId);
+}
+
+void MatchResultCache::clear()
+{
+    entries_.clear();
+    index_.clear();
+    byTrapdoor_.clear();
+    byEnc_.clear();
+}
+
+void MatchResultCache::eraseEntry(EntryIter it)
+{
+    const UniqueId trapdoorId = it->key.first;
+    const UniqueId encId = it->key.second;
+
+    auto tdIt = byTrapdoor_.find(trapdoorId);
+    if (tdIt != byTrapdoor_.end())
+    {
+        tdIt->second.erase(encId);
+        if (tdIt->second.empty())
+        {
+            byTrapdoor_.erase(tdIt);
+        }
+    }
+
+    auto encIt = byEnc_.find(encId);
+    if (encIt != byEnc_.end())
+    {
+        encIt->second.erase(trapdoorId);
+        if (encIt->second.empty())
+        {
+            byEnc_.erase(encIt);
+        }
+    }
+
+    index_.erase(it->key);
+    entries_.erase(it);
+}
+
+StripedMatchCache::StripedMatchCache(size_t capacity)
+{
+    size_t perStripe = (capacity + STRIPES - 1) / STRIPES;
+    for (auto &stripe : stripes_)
+    {
+        stripe.cache.reset(new MatchResultCache(perStripe));
+    }
+}
+
+bool StripedMatchCache::lookup(const UniqueId &trapdoorId, const UniqueId &encId, bool &matched)
+{
+    Stripe &stripe = stripeOf(trapdoorId, encId);
+    lock_guard<mutex> lock(stripe.mtx);
+    return stripe.cache->lookup(trapdoorId, encId, matched);
+}
+
+void StripedMatchCache::insert(const UniqueId &trapdoorId, const UniqueId &encId, bool matched)
+{
+    Stripe &stripe = stripeOf(trapdoorId, encId);
+    lock_guard<mutex> lock(stripe.mtx);
+    stripe.cache->insert(trapdoorId, encId, matched);
+}
+
+void StripedMatchCache::eraseTrapdoor(const UniqueId &trapdoorId)
+{
+    for (auto &stripe : stripes_)
+    {
+        lock_guard<mutex> lock(stripe.mtx);
+        stripe.cache->eraseTrapdoor(trapdoorId);
+    }
+}
+
+void StripedMatchCache::eraseEncapsulation(const UniqueId &encId)
+{
+    for (auto &stripe : stripes_)
+    {
+        lock_guard<mutex> lock(stripe.mtx);
+        stripe.cache->eraseEncapsulation(encId);
+    }
+}
+
+void StripedMatchCache::clear()
+{
+    for (auto &stripe : stripes_)
+    {
+        lock_guard<mutex> lock(stripe.mtx);
+        stripe.cache->clear();
+    }
+}
+
+StripedMatchCache::Stripe &StripedMatchCache::stripeOf(const UniqueId &trapdoorId, const UniqueId &encId)
+{
+    UniqueIdHash h;
+    return stripes_[(h(trapdoorId) ^ (h(encId) * 31)) % STRIPES];
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "unique_id.h"
+
+/**
+ * @brief 匹配结果缓存
+ *
+ * 以(陷门ID, 封装ID)为键缓存关键词匹配的验证结果，容量有界，按LRU淘汰。
+ * 额外维护按陷门ID与按封装ID的二级索引，陷门或封装数据被释放时
+ * 可一次性清除所有相关的匹配结果。本类本身不加锁，由调用方负责同步。
+ */
+class MatchResultCache
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最多缓存的匹配结果条数
+     */
+    explicit MatchResultCache(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief 查询缓存的匹配结果
+     * @param trapdoorId 陷门ID
+     * @param encId 封装ID
+     * @param matched 命中时写入匹配结果
+     * @return 是否命中
+     */
+    bool lookup(const UniqueId &trapdoorId, const UniqueId &encId, bool &matched);
+
+    /**
+     * @brief 写入匹配结果，超出容量时淘汰最久未使用的条目
+     */
+    void insert(const UniqueId &trapdoorId, const UniqueId &encId, bool matched);
+
+    /**
+     * @brief 清除某陷门的全部匹配结果
+     */
+    void eraseTrapdoor(const UniqueId &trapdoorId);
+
+    /**
+     * @brief 清除某封装数据的全部匹配结果
+     */
+    void eraseEncapsulation(const UniqueId &encId);
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear();
+
+    /**
+     * @brief 当前缓存条数
+     */
+    size_t size() const { return entries_.size(); }
+
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+private:
+    typedef std::pair<UniqueId, UniqueId> Key;
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const
+        {
+            UniqueIdHash h;
+            return h(key.first) ^ (h(key.second) * 31);
+        }
+    };
+
+    struct Entry
+    {
+        Key key;
+        bool matched;
+    };
+
+    typedef std::list<Entry>::iterator EntryIter;
+
+    // 从LRU链表与两个二级索引中移除一个条目
+    void eraseEntry(EntryIter it);
+
+    size_t capacity_;
+    std::list<Entry> entries_; // 表头为最近使用
+    std::unordered_map<Key, EntryIter, KeyHash> index_;
+    std::unordered_map<UniqueId, std::unordered_set<UniqueId, UniqueIdHash>, UniqueIdHash> byTrapdoor_;
+    std::unordered_map<UniqueId, std::unordered_set<UniqueId, UniqueIdHash>, UniqueIdHash> byEnc_;
+};
+
+/**
+ * @brief 分段加锁的匹配结果缓存
+ *
+ * 将(陷门ID, 封装ID)按哈希分到若干个独立加锁的MatchResultCache上，并发的
+ * 验证请求只在落入同一分段时才会互相等待。按陷门或按封装数据清除时依次
+ * 处理所有分段。
+ */
+class StripedMatchCache
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 所有分段合计最多缓存的匹配结果条数
+     */
+    explicit StripedMatchCache(size_t capacity = MatchResultCache::DEFAULT_CAPACITY);
+
+    bool lookup(const UniqueId &trapdoorId, const UniqueId &encId, bool &matched);
+    void insert(const UniqueId &trapdoorId, const UniqueId &encId, bool matched);
+    void eraseTrapdoor(const UniqueId &trapdoorId);
+    void eraseEncapsulation(const UniqueId &encId);
+    void clear();
+
+    static const size_t STRIPES = 16;
+
+private:
+    struct Stripe
+    {
+        std::mutex mtx;
+        std::unique_ptr<MatchResultCache> cache;
+    };
+
+    Stripe &stripeOf(const UniqueId &trapdoorId, const UniqueId &encId);
+
+    Stripe stripes_[STRIPES];
+};
@@ -1,7 +1,13 @@
 #include <napi.h>
 #include "crypto_engine.h"
 #include "crypto_engine_impl.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -17,15 +23,37 @@ private:
 
     // 封装CryptoEngine的方法
     Napi::Value SystemSetup(const Napi::CallbackInfo &info);
+    Napi::Value RotateMasterKeyAsync(const Napi::CallbackInfo &info);
     Napi::Value NodeRegistration(const Napi::CallbackInfo &info);
+    Napi::Value NodeRegistrationBatch(const Napi::CallbackInfo &info);
     Napi::Value GroupGeneration(const Napi::CallbackInfo &info);
+    Napi::Value GroupGenerationAsync(const Napi::CallbackInfo &info);
+    Napi::Value GroupAddMembers(const Napi::CallbackInfo &info);
+    Napi::Value GroupRemoveMembers(const Napi::CallbackInfo &info);
+    Napi::Value RegisterGroupVocabularyAsync(const Napi::CallbackInfo &info);
     Napi::Value ResourceEncryption(const Napi::CallbackInfo &info);
     Napi::Value ResourceDecryption(const Napi::CallbackInfo &info);
     Napi::Value SearchTokenGeneration(const Napi::CallbackInfo &info);
     Napi::Value Search(const Napi::CallbackInfo &info);
     Napi::Value VerifyKeywordMatch(const Napi::CallbackInfo &info);
+    Napi::Value VerifyKeywordMatchBatch(const Napi::CallbackInfo &info);
+    Napi::Value VerifyKeywordMatchBatchAsync(const Napi::CallbackInfo &info);
     Napi::Value EncapsulateKeyword(const Napi::CallbackInfo &info);
+    Napi::Value EncapsulateKeywordBatchAsync(const Napi::CallbackInfo &info);
+    Napi::Value EncapsulateRecordKeywords(const Napi::CallbackInfo &info);
     Napi::Value AllocateResourcesAccordingToKeywords(const Napi::CallbackInfo &info);
+    Napi::Value AllocateResourcesAsync(const Napi::CallbackInfo &info);
+    Napi::Value AllocateResourcesStream(const Napi::CallbackInfo &info);
+    Napi::Value AllocateResourcesTopKAsync(const Napi::CallbackInfo &info);
+    Napi::Value AllocateResourcesBatchAsync(const Napi::CallbackInfo &info);
+    Napi::Value MatchKeywordQueryAsync(const Napi::CallbackInfo &info);
+    Napi::Value AllocateResourcesByQueryAsync(const Napi::CallbackInfo &info);
+    Napi::Value ReleaseTrapdoor(const Napi::CallbackInfo &info);
+    Napi::Value ReleaseEncapsulation(const Napi::CallbackInfo &info);
+    Napi::Value SetWorkerThreads(const Napi::CallbackInfo &info);
+    Napi::Value SetAllocationPolicy(const Napi::CallbackInfo &info);
+    Napi::Value SetDerivedNodeKeys(const Napi::CallbackInfo &info);
+    Napi::Value UpdateNodeLoads(const Napi::CallbackInfo &info);
 
     // 底层CryptoEngine实例
     std::unique_ptr<CryptoEngineImpl> engine;
@@ -33,58 +61,1441 @@ private:
 
 Napi::FunctionReference CryptoEngineWrapper::constructor;
 
+// 读取JS字符串数组，元素类型不符时抛出TypeError并返回false
+static bool ReadStringArray(Napi::Env env, const Napi::Array &array, const char *message, std::vector<std::string> &out)
+{
+    out.clear();
+    out.reserve(array.Length());
+    for (uint32_t i = 0; i < array.Length(); i++)
+    {
+        Napi::Value value = array[i];
+        if (!value.IsString())
+        {
+            Napi::TypeError::New(env, message).ThrowAsJavaScriptException();
+            return false;
+        }
+        out.push_back(value.As<Napi::String>());
+    }
+    return true;
+}
+
+// 将匹配结果转换为JS布尔数组
+static Napi::Array ToBooleanArray(Napi::Env env, const std::vector<bool> &results)
+{
+    Napi::Array array = Napi::Array::New(env, results.size());
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        array.Set(static_cast<uint32_t>(i), Napi::Boolean::New(env, results[i]));
+    }
+    return array;
+}
+
+// 在后台线程上执行work，完成后在JS线程上以toValue的返回值兑现Promise
+class PromiseWorker : public Napi::AsyncWorker
+{
+public:
+    PromiseWorker(Napi::Env env, Napi::Object owner, std::function<void()> work,
+                  std::function<Napi::Value(Napi::Env)> toValue, std::function<void()> onSettled)
+        : Napi::AsyncWorker(env),
+          deferred(Napi::Promise::Deferred::New(env)),
+          work(std::move(work)),
+          toValue(std::move(toValue)),
+          onSettled(std::move(onSettled))
+    {
+        // 持有包装对象的引用，避免后台任务执行期间引擎被回收
+        ownerRef = Napi::Persistent(owner);
+    }
+
+    Napi::Promise GetPromise() const
+    {
+        return deferred.Promise();
+    }
+
+protected:
+    void Execute() override
+    {
+        try
+        {
+            work();
+        }
+        catch (const std::exception &e)
+        {
+            SetError(e.what());
+        }
+    }
+
+    void OnOK() override
+    {
+        Napi::HandleScope scope(Env());
+        if (onSettled)
+        {
+            onSettled();
+        }
+        deferred.Resolve(toValue(Env()));
+    }
+
+    void OnError(const Napi::Error &e) override
+    {
+        Napi::HandleScope scope(Env());
+        if (onSettled)
+        {
+            onSettled();
+        }
+        deferred.Reject(e.Value());
+    }
+
+private:
+    Napi::Promise::Deferred deferred;
+    Napi::ObjectReference ownerRef;
+    std::function<void()> work;
+    std::function<Napi::Value(Napi::Env)> toValue;
+    std::function<void()> onSettled; // 在JS线程上兑现Promise之前调用
+};
+
+// 返回一个Promise：MIRACL支持多线程时work在后台线程上执行，否则在JS线程上同步执行
+// onSettled(可为空)在Promise兑现或拒绝之前于JS线程上调用
+static Napi::Value RunAsPromise(Napi::Env env, Napi::Object owner, std::function<void()> work,
+                                std::function<Napi::Value(Napi::Env)> toValue,
+                                std::function<void()> onSettled = nullptr)
+{
+    if (!CryptoEngineImpl::supportsBackgroundThreads())
+    {
+        // 与后台执行的约定一致：work抛出的异常拒绝Promise，而不是同步抛给调用方
+        Napi::Promise::Deferred deferred = Napi::Promise::Deferred::New(env);
+        try
+        {
+            work();
+        }
+        catch (const std::exception &e)
+        {
+            if (onSettled)
+            {
+                onSettled();
+            }
+            deferred.Reject(Napi::Error::New(env, e.what()).Value());
+            return deferred.Promise();
+        }
+        if (onSettled)
+        {
+            onSettled();
+        }
+        deferred.Resolve(toValue(env));
+        return deferred.Promise();
+    }
+
+    PromiseWorker *worker = new PromiseWorker(env, owner, std::move(work), std::move(toValue), std::move(onSettled));
+    Napi::Promise promise = worker->GetPromise();
+    worker->Queue();
+    return promise;
+}
+
+// 将JS调用方的取消选项({signal, timeoutMs})关联到取消令牌
+// signal兼容AbortSignal：已中止时立即取消，否则监听abort事件；Promise完成后调用Detach移除监听
+class CancellationLink
+{
+public:
+    CancellationLink() : token(std::make_shared<CancellationToken>()) {}
+
+    // 读取选项对象，格式不符时抛出TypeError并返回false
+    bool Read(Napi::Env env, Napi::Value options)
+    {
+        if (options.IsUndefined() || options.IsNull())
+        {
+            return true;
+        }
+        if (!options.IsObject())
+        {
+            Napi::TypeError::New(env, "Options must be an object").ThrowAsJavaScriptException();
+            return false;
+        }
+        Napi::Object object = options.As<Napi::Object>();
+
+        Napi::Value timeout = object.Get("timeoutMs");
+        if (!timeout.IsUndefined())
+        {
+            double millis = timeout.IsNumber() ? timeout.As<Napi::Number>().DoubleValue() : -1;
+            if (std::isnan(millis) || millis < 0)
+            {
+                Napi::TypeError::New(env, "timeoutMs must be a non-negative number").ThrowAsJavaScriptException();
+                return false;
+            }
+            // Infinity表示不设截止时间；超出int64范围的有限值按最大值传入，由setTimeout饱和处理
+            if (!std::isinf(millis))
+            {
+                int64_t ticks = millis < 9.2e18 ? static_cast<int64_t>(millis) : INT64_MAX;
+                token->setTimeout(std::chrono::milliseconds(ticks));
+            }
+        }
+
+        Napi::Value signalValue = object.Get("signal");
+        if (signalValue.IsUndefined() || signalValue.IsNull())
+        {
+            return true;
+        }
+        if (!signalValue.IsObject() || !signalValue.As<Napi::Object>().Get("addEventListener").IsFunction())
+        {
+            Napi::TypeError::New(env, "signal must be an AbortSignal").ThrowAsJavaScriptException();
+            return false;
+        }
+
+        Napi::Object abortSignal = signalValue.As<Napi::Object>();
+        if (abortSignal.Get("aborted").ToBoolean())
+        {
+            token->cancel();
+            return true;
+        }
+
+        std::shared_ptr<CancellationToken> target = token;
+        Napi::Function onAbort = Napi::Function::New(env, [target](const Napi::CallbackInfo &) { target->cancel(); });
+        abortSignal.Get("addEventListener").As<Napi::Function>().Call(abortSignal, {Napi::String::New(env, "abort"), onAbort});
+        signal = Napi::Persistent(abortSignal);
+        listener = Napi::Persistent(onAbort);
+        return true;
+    }
+
+    // 移除abort监听(只能在JS线程上调用)
+    void Detach()
+    {
+        if (signal.IsEmpty())
+        {
+            return;
+        }
+        Napi::Env env = signal.Env();
+        Napi::Object abortSignal = signal.Value();
+        Napi::Value remove = abortSignal.Get("removeEventListener");
+        if (remove.IsFunction())
+        {
+            remove.As<Napi::Function>().Call(abortSignal, {Napi::String::New(env, "abort"), listener.Value()});
+        }
+        signal.Reset();
+        listener.Reset();
+    }
+
+    std::shared_ptr<CancellationToken> token;
+
+private:
+    Napi::ObjectReference signal;
+    Napi::FunctionReference listener;
+};
+
+// 读取选项对象中的需求量(options.demand，缺省为1)，格式不符时抛出TypeError并返回false
+static bool ReadDemand(Napi::Env env, Napi::Value options, double &demand)
+{
+    if (!options.IsObject())
+    {
+        return true;
+    }
+    Napi::Value value = options.As<Napi::Object>().Get("demand");
+    if (value.IsUndefined())
+    {
+        return true;
+    }
+    if (!value.IsNumber() || value.As<Napi::Number>().DoubleValue() < 0)
+    {
+        Napi::TypeError::New(env, "demand must be a non-negative number").ThrowAsJavaScriptException();
+        return false;
+    }
+    demand = value.As<Napi::Number>().DoubleValue();
+    return true;
+}
+
+// 关键词查询表达式允许的最大嵌套层数
+static const int MAX_QUERY_DEPTH = 16;
+
+// 读取关键词查询表达式：陷门字符串、{and: [...]}或{or: [...]}；相同的陷门共用一个陷门项
+static bool ReadQueryNode(Napi::Env env, Napi::Value value, int depth, KeywordQuery &query,
+                          std::vector<std::string> &trapdoors, std::map<std::string, size_t> &termOf, size_t &node)
+{
+    if (value.IsString())
+    {
+        std::string trapdoor = value.As<Napi::String>();
+        auto inserted = termOf.emplace(trapdoor, trapdoors.size());
+        if (inserted.second)
+        {
+            trapdoors.push_back(trapdoor);
+        }
+        node = query.addTerm(inserted.first->second);
+        return true;
+    }
+
+    if (depth >= MAX_QUERY_DEPTH || !value.IsObject())
+    {
+        Napi::TypeError::New(env, "Query must be a trapdoor string or {and: [...]} / {or: [...]}").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Object object = value.As<Napi::Object>();
+    bool isAnd = object.Has("and");
+    Napi::Value operands = object.Get(isAnd ? "and" : "or");
+    if (!operands.IsArray() || operands.As<Napi::Array>().Length() == 0)
+    {
+        Napi::TypeError::New(env, "Query operands must be a non-empty array").ThrowAsJavaScriptException();
+        return false;
+    }
+
+    Napi::Array array = operands.As<Napi::Array>();
+    std::vector<size_t> children;
+    for (uint32_t i = 0; i < array.Length(); i++)
+    {
+        size_t child = 0;
+        if (!ReadQueryNode(env, array.Get(i), depth + 1, query, trapdoors, termOf, child))
+        {
+            return false;
+        }
+        children.push_back(child);
+    }
+    node = isAnd ? query.addAnd(children) : query.addOr(children);
+    return true;
+}
+
+static bool ReadKeywordQuery(Napi::Env env, Napi::Value value, KeywordQuery &query, std::vector<std::string> &trapdoors)
+{
+    std::map<std::string, size_t> termOf;
+    size_t root = 0;
+    if (!ReadQueryNode(env, value, 0, query, trapdoors, termOf, root))
+    {
+        return false;
+    }
+    query.setRoot(root);
+    return true;
+}
+
+// 构造{status, ...}形式的批量结果对象
+static Napi::Object NewBatchResult(Napi::Env env, BatchStatus status)
+{
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("status", Napi::String::New(env, batchStatusName(status)));
+    return result;
+}
+
+// 流式分配的共享状态：工作线程写入统计结果，JS线程在线程安全函数析构时兑现Promise
+struct MatchStreamState
+{
+    explicit MatchStreamState(Napi::Env env) : deferred(Napi::Promise::Deferred::New(env)) {}
+
+    Napi::Promise::Deferred deferred;
+    Napi::ObjectReference ownerRef; // 持有包装对象，避免扫描期间引擎被回收
+    CancellationLink link;
+    std::vector<std::string> edgeNodeIds;
+    MatchScanResult result;
+    size_t delivered = 0;    // 实际交给回调的匹配数(取消后丢弃的块不计)，只在JS线程上读写
+    std::string error;       // 回调抛出的异常，只在JS线程上读写
+    std::string workerError; // 扫描抛出的异常，只在工作线程上写入，释放线程安全函数后才在JS线程上读取
+};
+
+// 一块匹配结果，经线程安全函数从工作线程转交到JS线程
+struct MatchStreamChunk
+{
+    std::vector<size_t> indices;
+    std::shared_ptr<MatchStreamState> state;
+};
+
+// 在JS线程上以{indices, nodeIds}调用回调，回调返回false时停止扫描
+static void DeliverMatchChunk(Napi::Env env, Napi::Function onChunk, MatchStreamChunk *chunk)
+{
+    std::unique_ptr<MatchStreamChunk> owned(chunk);
+    if (env == nullptr || owned->state->link.token->stopRequested())
+    {
+        return;
+    }
+
+    Napi::Array indices = Napi::Array::New(env, owned->indices.size());
+    Napi::Array nodeIds = Napi::Array::New(env, owned->indices.size());
+    const std::vector<std::string> &edgeNodeIds = owned->state->edgeNodeIds;
+    for (size_t i = 0; i < owned->indices.size(); i++)
+    {
+        size_t index = owned->indices[i];
+        indices.Set(static_cast<uint32_t>(i), Napi::Number::New(env, static_cast<double>(index)));
+        nodeIds.Set(static_cast<uint32_t>(i), index < edgeNodeIds.size() ? Napi::String::New(env, edgeNodeIds[index]) : env.Null());
+    }
+    Napi::Object value = Napi::Object::New(env);
+    value.Set("indices", indices);
+    value.Set("nodeIds", nodeIds);
+    owned->state->delivered += owned->indices.size();
+
+    try
+    {
+        Napi::Value keepGoing = onChunk.Call({value});
+        if (keepGoing.IsBoolean() && !keepGoing.As<Napi::Boolean>().Value())
+        {
+            owned->state->link.token->cancel();
+        }
+    }
+    catch (const Napi::Error &e)
+    {
+        // 回调抛出异常时停止扫描，并以该异常拒绝Promise
+        if (owned->state->error.empty())
+        {
+            owned->state->error = e.Message();
+        }
+        owned->state->link.token->cancel();
+    }
+}
+
+// 在后台线程上执行流式扫描，结束后释放线程安全函数(其析构回调在JS线程上兑现Promise)
+class MatchStreamWorker : public Napi::AsyncWorker
+{
+public:
+    MatchStreamWorker(Napi::Env env, CryptoEngineImpl *engine, Napi::ThreadSafeFunction tsfn,
+                      std::shared_ptr<MatchStreamState> state, std::string trapdoor,
+                      std::vector<std::string> encryptedMetadataList)
+        : Napi::AsyncWorker(env),
+          engine(engine),
+          tsfn(tsfn),
+          state(std::move(state)),
+          trapdoor(std::move(trapdoor)),
+          encryptedMetadataList(std::move(encryptedMetadataList))
+    {
+    }
+
+protected:
+    void Execute() override
+    {
+        Napi::ThreadSafeFunction target = tsfn;
+        std::shared_ptr<MatchStreamState> shared = state;
+        try
+        {
+            state->result = engine->streamKeywordMatches(
+                trapdoor, encryptedMetadataList,
+                [target, shared](const std::vector<size_t> &indices)
+                {
+                    // 回调只在本线程(而非调度器的工作线程)上调用，队列已满时阻塞本线程，直到JS线程消费了之前的块
+                    MatchStreamChunk *chunk = new MatchStreamChunk{indices, shared};
+                    if (target.BlockingCall(chunk, DeliverMatchChunk) != napi_ok)
+                    {
+                        delete chunk;
+                        shared->link.token->cancel();
+                    }
+                },
+                *state->link.token);
+        }
+        catch (const std::exception &e)
+        {
+            state->workerError = e.what();
+        }
+        tsfn.Release();
+    }
+
+    void OnOK() override {}
+
+private:
+    CryptoEngineImpl *engine;
+    Napi::ThreadSafeFunction tsfn;
+    std::shared_ptr<MatchStreamState> state;
+    std::string trapdoor;
+    std::vector<std::string> encryptedMetadataList;
+};
+
+// 流式分配结束后兑现Promise
+static void SettleMatchStream(Napi::Env env, MatchStreamState &state)
+{
+    state.link.Detach();
+    state.ownerRef.Reset();
+    // 回调的异常先于扫描的异常，线程安全函数的析构回调晚于工作线程的全部写入
+    const std::string &error = state.error.empty() ? state.workerError : state.error;
+    if (!error.empty())
+    {
+        state.deferred.Reject(Napi::Error::New(env, error).Value());
+        return;
+    }
+    Napi::Object result = NewBatchResult(env, state.result.status);
+    result.Set("matched", Napi::Number::New(env, static_cast<double>(state.delivered)));
+    result.Set("evaluated", Napi::Number::New(env, static_cast<double>(state.result.evaluated)));
+    state.deferred.Resolve(result);
+}
+
 Napi::Object CryptoEngineWrapper::Init(Napi::Env env, Napi::Object exports)
 {
     Napi::HandleScope scope(env);
 
-    Napi::Function func = DefineClass(env, "CryptoEngine", {InstanceMethod("systemSetup", &CryptoEngineWrapper::SystemSetup), InstanceMethod("nodeRegistration", &CryptoEngineWrapper::NodeRegistration), InstanceMethod("groupGeneration", &CryptoEngineWrapper::GroupGeneration), InstanceMethod("resourceEncryption", &CryptoEngineWrapper::ResourceEncryption), InstanceMethod("resourceDecryption", &CryptoEngineWrapper::ResourceDecryption), InstanceMethod("searchTokenGeneration", &CryptoEngineWrapper::SearchTokenGeneration), InstanceMethod("search", &CryptoEngineWrapper::Search), InstanceMethod("verifyKeywordMatch", &CryptoEngineWrapper::VerifyKeywordMatch), InstanceMethod("encapsulateKeyword", &CryptoEngineWrapper::EncapsulateKeyword), InstanceMethod("allocateResourcesAccordingToKeywords", &CryptoEngineWrapper::AllocateResourcesAccordingToKeywords)});
+    Napi::Function func = DefineClass(env, "CryptoEngine", {InstanceMethod("systemSetup", &CryptoEngineWrapper::SystemSetup), InstanceMethod("rotateMasterKeyAsync", &CryptoEngineWrapper::RotateMasterKeyAsync), InstanceMethod("nodeRegistration", &CryptoEngineWrapper::NodeRegistration), InstanceMethod("nodeRegistrationBatch", &CryptoEngineWrapper::NodeRegistrationBatch), InstanceMethod("groupGeneration", &CryptoEngineWrapper::GroupGeneration), InstanceMethod("groupGenerationAsync", &CryptoEngineWrapper::GroupGenerationAsync), InstanceMethod("groupAddMembers", &CryptoEngineWrapper::GroupAddMembers), InstanceMethod("groupRemoveMembers", &CryptoEngineWrapper::GroupRemoveMembers), InstanceMethod("registerGroupVocabularyAsync", &CryptoEngineWrapper::RegisterGroupVocabularyAsync), InstanceMethod("resourceEncryption", &CryptoEngineWrapper::ResourceEncryption), InstanceMethod("resourceDecryption", &CryptoEngineWrapper::ResourceDecryption), InstanceMethod("searchTokenGeneration", &CryptoEngineWrapper::SearchTokenGeneration), InstanceMethod("search", &CryptoEngineWrapper::Search), InstanceMethod("verifyKeywordMatch", &CryptoEngineWrapper::VerifyKeywordMatch), InstanceMethod("verifyKeywordMatchBatch", &CryptoEngineWrapper::VerifyKeywordMatchBatch), InstanceMethod("verifyKeywordMatchBatchAsync", &CryptoEngineWrapper::VerifyKeywordMatchBatchAsync), InstanceMethod("encapsulateKeyword", &CryptoEngineWrapper::EncapsulateKeyword), InstanceMethod("encapsulateKeywordBatchAsync", &CryptoEngineWrapper::EncapsulateKeywordBatchAsync), InstanceMethod("encapsulateRecordKeywords", &CryptoEngineWrapper::EncapsulateRecordKeywords), InstanceMethod("allocateResourcesAccordingToKeywords", &CryptoEngineWrapper::AllocateResourcesAccordingToKeywords), InstanceMethod("allocateResourcesAsync", &CryptoEngineWrapper::AllocateResourcesAsync), InstanceMethod("allocateResourcesStream", &CryptoEngineWrapper::AllocateResourcesStream), InstanceMethod("allocateResourcesTopKAsync", &CryptoEngineWrapper::AllocateResourcesTopKAsync), InstanceMethod("allocateResourcesBatchAsync", &CryptoEngineWrapper::AllocateResourcesBatchAsync), InstanceMethod("matchKeywordQueryAsync", &CryptoEngineWrapper::MatchKeywordQueryAsync), InstanceMethod("allocateResourcesByQueryAsync", &CryptoEngineWrapper::AllocateResourcesByQueryAsync), InstanceMethod("releaseTrapdoor", &CryptoEngineWrapper::ReleaseTrapdoor), InstanceMethod("releaseEncapsulation", &CryptoEngineWrapper::ReleaseEncapsulation), InstanceMethod("setWorkerThreads", &CryptoEngineWrapper::SetWorkerThreads), InstanceMethod("setAllocationPolicy", &CryptoEngineWrapper::SetAllocationPolicy), InstanceMethod("setDerivedNodeKeys", &CryptoEngineWrapper::SetDerivedNodeKeys), InstanceMethod("updateNodeLoads", &CryptoEngineWrapper::UpdateNodeLoads)});
+
+    constructor = Napi::Persistent(func);
+    constructor.SuppressDestruct();
+
+    exports.Set("CryptoEngine", func);
+    return exports;
+}
+
+CryptoEngineWrapper::CryptoEngineWrapper(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<CryptoEngineWrapper>(info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        // 创建CryptoEngine实例
+        engine = std::make_unique<CryptoEngineImpl>();
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, "Failed to create CryptoEngine: " + std::string(e.what())).ThrowAsJavaScriptException();
+    }
+}
+
+CryptoEngineWrapper::~CryptoEngineWrapper()
+{
+    // 析构函数自动处理engine的释放
+}
+
+Napi::Value CryptoEngineWrapper::SystemSetup(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsNumber())
+        {
+            Napi::TypeError::New(env, "Number expected for securityLevel").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        int securityLevel = info[0].As<Napi::Number>().Int32Value();
+
+        // 可选的参数：{nodeTag}，多实例部署时区分各后端进程生成的唯一ID
+        int nodeTag = -1;
+        if (info.Length() > 1 && !info[1].IsUndefined() && !info[1].IsNull())
+        {
+            if (!info[1].IsObject())
+            {
+                Napi::TypeError::New(env, "Options must be an object").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            Napi::Value tag = info[1].As<Napi::Object>().Get("nodeTag");
+            if (!tag.IsUndefined())
+            {
+                double value = tag.IsNumber() ? tag.As<Napi::Number>().DoubleValue() : -1;
+                if (!(value >= 0 && value <= 65535) || value != std::floor(value))
+                {
+                    Napi::TypeError::New(env, "nodeTag must be an integer in [0, 65535]").ThrowAsJavaScriptException();
+                    return env.Null();
+                }
+                nodeTag = static_cast<int>(value);
+            }
+        }
+
+        bool result = engine->systemSetup(securityLevel, nodeTag);
+
+        return Napi::Boolean::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::RotateMasterKeyAsync(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        // 可选的参数：{signal, timeoutMs}
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 1 && !link->Read(env, info[0]))
+        {
+            return env.Null();
+        }
+
+        auto epoch = std::make_shared<uint64_t>(0);
+        auto status = std::make_shared<BatchStatus>(BatchStatus::Completed);
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, token, epoch, status]() { *epoch = target->rotateMasterKey(*token, *status); },
+            [epoch, status](Napi::Env env) -> Napi::Value
+            {
+                Napi::Object result = NewBatchResult(env, *status);
+                result.Set("epoch", Napi::Number::New(env, static_cast<double>(*epoch)));
+                return result;
+            },
+            [link]() { link->Detach(); });
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::NodeRegistration(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsString())
+        {
+            Napi::TypeError::New(env, "String expected for nodeId").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string nodeId = info[0].As<Napi::String>();
+        auto result = engine->nodeRegistration(nodeId);
+
+        Napi::Object obj = Napi::Object::New(env);
+        obj.Set("nodeId", Napi::String::New(env, result.first));
+        obj.Set("key", Napi::String::New(env, result.second));
+
+        return obj;
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::NodeRegistrationBatch(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsArray())
+        {
+            Napi::TypeError::New(env, "Array expected for nodeIds").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        Napi::Array nodeIdsArray = info[0].As<Napi::Array>();
+        std::vector<std::string> nodeIds;
+
+        for (uint32_t i = 0; i < nodeIdsArray.Length(); i++)
+        {
+            Napi::Value value = nodeIdsArray[i];
+            if (!value.IsString())
+            {
+                Napi::TypeError::New(env, "Array elements must be strings").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            nodeIds.push_back(value.As<Napi::String>());
+        }
+
+        auto results = engine->nodeRegistrationBatch(nodeIds);
+
+        Napi::Array resultArray = Napi::Array::New(env, results.size());
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            Napi::Object obj = Napi::Object::New(env);
+            obj.Set("nodeId", Napi::String::New(env, results[i].first));
+            obj.Set("key", Napi::String::New(env, results[i].second));
+            resultArray[i] = obj;
+        }
+
+        return resultArray;
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::GroupGeneration(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsArray())
+        {
+            Napi::TypeError::New(env, "Array expected for nodeIds").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        Napi::Array nodeIdsArray = info[0].As<Napi::Array>();
+        std::vector<std::string> nodeIds;
+
+        for (uint32_t i = 0; i < nodeIdsArray.Length(); i++)
+        {
+            Napi::Value value = nodeIdsArray[i];
+            if (!value.IsString())
+            {
+                Napi::TypeError::New(env, "Array elements must be strings").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            nodeIds.push_back(value.As<Napi::String>());
+        }
+
+        std::string result = engine->groupGeneration(nodeIds);
+        return Napi::String::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::GroupGenerationAsync(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 1 || !info[0].IsArray())
+        {
+            Napi::TypeError::New(env, "Array expected for nodeIds").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        auto nodeIds = std::make_shared<std::vector<std::string>>();
+        if (!ReadStringArray(env, info[0].As<Napi::Array>(), "Array elements must be strings", *nodeIds))
+        {
+            return env.Null();
+        }
+
+        // 可选的第二个参数：{signal, timeoutMs, hierarchical}
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 2 && !link->Read(env, info[1]))
+        {
+            return env.Null();
+        }
+        GroupLayout layout = GroupLayout::Flat;
+        if (info.Length() >= 2 && info[1].IsObject() && info[1].As<Napi::Object>().Get("hierarchical").ToBoolean())
+        {
+            layout = GroupLayout::Hierarchical;
+        }
+
+        auto groupId = std::make_shared<std::string>();
+        auto status = std::make_shared<BatchStatus>(BatchStatus::Completed);
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, nodeIds, token, layout, groupId, status]() { *groupId = target->groupGeneration(*nodeIds, *token, *status, layout); },
+            [groupId, status](Napi::Env env) -> Napi::Value
+            {
+                Napi::Object result = NewBatchResult(env, *status);
+                result.Set("groupId", Napi::String::New(env, *groupId));
+                return result;
+            },
+            [link]() { link->Detach(); });
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::GroupAddMembers(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected: groupId(string), nodeIds(array)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::vector<std::string> nodeIds;
+        if (!ReadStringArray(env, info[1].As<Napi::Array>(), "Array elements must be strings", nodeIds))
+        {
+            return env.Null();
+        }
+
+        bool updated = engine->groupAddMembers(info[0].As<Napi::String>(), nodeIds);
+        return Napi::Boolean::New(env, updated);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::GroupRemoveMembers(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected: groupId(string), nodeIds(array)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::vector<std::string> nodeIds;
+        if (!ReadStringArray(env, info[1].As<Napi::Array>(), "Array elements must be strings", nodeIds))
+        {
+            return env.Null();
+        }
+
+        bool updated = engine->groupRemoveMembers(info[0].As<Napi::String>(), nodeIds);
+        return Napi::Boolean::New(env, updated);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::RegisterGroupVocabularyAsync(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected: groupId(string), keywords(array)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string groupId = info[0].As<Napi::String>();
+        auto keywords = std::make_shared<std::vector<std::string>>();
+        if (!ReadStringArray(env, info[1].As<Napi::Array>(), "Keyword array elements must be strings", *keywords))
+        {
+            return env.Null();
+        }
+
+        // 可选的第三个参数：{signal, timeoutMs, precomputeBases}
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 3 && !link->Read(env, info[2]))
+        {
+            return env.Null();
+        }
+        bool precomputeBases = info.Length() >= 3 && info[2].IsObject() &&
+                               info[2].As<Napi::Object>().Get("precomputeBases").ToBoolean();
+
+        auto prepared = std::make_shared<size_t>(0);
+        auto status = std::make_shared<BatchStatus>(BatchStatus::Completed);
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, groupId, keywords, precomputeBases, token, prepared, status]()
+            { *prepared = target->registerGroupVocabulary(groupId, *keywords, precomputeBases, *token, *status); },
+            [prepared, status](Napi::Env env) -> Napi::Value
+            {
+                Napi::Object result = NewBatchResult(env, *status);
+                result.Set("prepared", Napi::Number::New(env, static_cast<double>(*prepared)));
+                return result;
+            },
+            [link]() { link->Detach(); });
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::ResourceEncryption(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        {
+            Napi::TypeError::New(env, "String expected for plaintext and key").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string plaintext = info[0].As<Napi::String>();
+        std::string key = info[1].As<Napi::String>();
+
+        std::string result = engine->resourceEncryption(plaintext, key);
+        return Napi::String::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::ResourceDecryption(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        {
+            Napi::TypeError::New(env, "String expected for ciphertext and key").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string ciphertext = info[0].As<Napi::String>();
+        std::string key = info[1].As<Napi::String>();
+
+        std::string result = engine->resourceDecryption(ciphertext, key);
+        return Napi::String::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::SearchTokenGeneration(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        {
+            Napi::TypeError::New(env, "String expected for keyword and key").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string keyword = info[0].As<Napi::String>();
+        std::string key = info[1].As<Napi::String>();
+
+        std::string result = engine->searchTokenGeneration(keyword, key);
+        return Napi::String::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::Search(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray())
+        {
+            Napi::TypeError::New(env, "String expected for token and Array for encryptedDocs").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string token = info[0].As<Napi::String>();
+        Napi::Array docsArray = info[1].As<Napi::Array>();
+        std::vector<std::string> encryptedDocs;
+
+        for (uint32_t i = 0; i < docsArray.Length(); i++)
+        {
+            Napi::Value value = docsArray[i];
+            if (!value.IsString())
+            {
+                Napi::TypeError::New(env, "Array elements must be strings").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            encryptedDocs.push_back(value.As<Napi::String>());
+        }
+
+        std::vector<std::string> results = engine->search(token, encryptedDocs);
+
+        Napi::Array resultArray = Napi::Array::New(env, results.size());
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            resultArray[i] = Napi::String::New(env, results[i]);
+        }
+
+        return resultArray;
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::VerifyKeywordMatch(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        {
+            Napi::TypeError::New(env, "String expected for trapdoor and encryptedMetadata").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string trapdoor = info[0].As<Napi::String>();
+        std::string encryptedMetadata = info[1].As<Napi::String>();
+
+        bool result = engine->verifyKeywordMatch(trapdoor, encryptedMetadata);
+        return Napi::Boolean::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::VerifyKeywordMatchBatch(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected: trapdoors(array), encryptedMetadataList(array)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::vector<std::string> trapdoors;
+        std::vector<std::string> encryptedMetadataList;
+        if (!ReadStringArray(env, info[0].As<Napi::Array>(), "Trapdoor array elements must be strings", trapdoors) ||
+            !ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", encryptedMetadataList))
+        {
+            return env.Null();
+        }
+
+        if (trapdoors.size() != encryptedMetadataList.size())
+        {
+            Napi::TypeError::New(env, "Trapdoor and metadata arrays must have the same length").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::vector<bool> results = engine->verifyKeywordMatchBatch(trapdoors, encryptedMetadataList);
+        return ToBooleanArray(env, results);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::VerifyKeywordMatchBatchAsync(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected: trapdoors(array), encryptedMetadataList(array)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::vector<std::string> trapdoors;
+        std::vector<std::string> encryptedMetadataList;
+        if (!ReadStringArray(env, info[0].As<Napi::Array>(), "Trapdoor array elements must be strings", trapdoors) ||
+            !ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", encryptedMetadataList))
+        {
+            return env.Null();
+        }
+
+        if (trapdoors.size() != encryptedMetadataList.size())
+        {
+            Napi::TypeError::New(env, "Trapdoor and metadata arrays must have the same length").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        // 可选的第三个参数：{signal, timeoutMs}
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 3 && !link->Read(env, info[2]))
+        {
+            return env.Null();
+        }
+
+        auto results = std::make_shared<VerifyBatchResult>();
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        auto inputs = std::make_shared<std::pair<std::vector<std::string>, std::vector<std::string>>>(
+            std::move(trapdoors), std::move(encryptedMetadataList));
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, inputs, token, results]() { *results = target->verifyKeywordMatchBatch(inputs->first, inputs->second, *token); },
+            [results](Napi::Env env) -> Napi::Value
+            {
+                // 未验证的条目为null
+                Napi::Array array = Napi::Array::New(env, results->matched.size());
+                for (size_t i = 0; i < results->matched.size(); i++)
+                {
+                    array.Set(static_cast<uint32_t>(i), results->evaluated[i] ? Napi::Boolean::New(env, results->matched[i]) : env.Null());
+                }
+                Napi::Object result = NewBatchResult(env, results->status);
+                result.Set("results", array);
+                return result;
+            },
+            [link]() { link->Detach(); });
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::EncapsulateKeyword(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        {
+            Napi::TypeError::New(env, "String expected for keyword and metadata").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string keyword = info[0].As<Napi::String>();
+        std::string metadata = info[1].As<Napi::String>();
+
+        std::string result = engine->encapsulateKeyword(keyword, metadata);
+        return Napi::String::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::EncapsulateRecordKeywords(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsString())
+        {
+            Napi::TypeError::New(env, "Expected: keywords(array), groupId(string)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::vector<std::string> keywords;
+        if (!ReadStringArray(env, info[0].As<Napi::Array>(), "Keyword array elements must be strings", keywords))
+        {
+            return env.Null();
+        }
+        std::string groupId = info[1].As<Napi::String>();
+
+        std::string result = engine->encapsulateKeywords(keywords, groupId);
+        return Napi::String::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::EncapsulateKeywordBatchAsync(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsString())
+        {
+            Napi::TypeError::New(env, "Expected: keywords(array), groupId(string)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        auto keywords = std::make_shared<std::vector<std::string>>();
+        if (!ReadStringArray(env, info[0].As<Napi::Array>(), "Keyword array elements must be strings", *keywords))
+        {
+            return env.Null();
+        }
+        std::string groupId = info[1].As<Napi::String>();
+
+        // 可选的第三个参数：{signal, timeoutMs}
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 3 && !link->Read(env, info[2]))
+        {
+            return env.Null();
+        }
+
+        auto results = std::make_shared<EncapsulationBatchResult>();
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, keywords, groupId, token, results]() { *results = target->encapsulateKeywordBatch(*keywords, groupId, *token); },
+            [results](Napi::Env env) -> Napi::Value
+            {
+                // 未处理的条目为null
+                Napi::Array array = Napi::Array::New(env, results->encapsulations.size());
+                for (size_t i = 0; i < results->encapsulations.size(); i++)
+                {
+                    array.Set(static_cast<uint32_t>(i), results->evaluated[i] ? Napi::String::New(env, results->encapsulations[i]) : env.Null());
+                }
+                Napi::Object result = NewBatchResult(env, results->status);
+                result.Set("encapsulations", array);
+                return result;
+            },
+            [link]() { link->Detach(); });
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::AllocateResourcesAccordingToKeywords(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 3 || !info[0].IsString() || !info[1].IsArray() || !info[2].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected: trapdoor(string), encryptedMetadataList(array), edgeNodeIds(array)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string trapdoor = info[0].As<Napi::String>();
+
+        Napi::Array metadataArray = info[1].As<Napi::Array>();
+        std::vector<std::string> encryptedMetadataList;
+        for (uint32_t i = 0; i < metadataArray.Length(); i++)
+        {
+            Napi::Value value = metadataArray[i];
+            if (!value.IsString())
+            {
+                Napi::TypeError::New(env, "Metadata array elements must be strings").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            encryptedMetadataList.push_back(value.As<Napi::String>());
+        }
+
+        Napi::Array nodesArray = info[2].As<Napi::Array>();
+        std::vector<std::string> edgeNodeIds;
+        for (uint32_t i = 0; i < nodesArray.Length(); i++)
+        {
+            Napi::Value value = nodesArray[i];
+            if (!value.IsString())
+            {
+                Napi::TypeError::New(env, "Node array elements must be strings").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            edgeNodeIds.push_back(value.As<Napi::String>());
+        }
+
+        std::string result = engine->allocateResourcesAccordingToKeywords(trapdoor, encryptedMetadataList, edgeNodeIds);
+        return Napi::String::New(env, result);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value CryptoEngineWrapper::AllocateResourcesAsync(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+    Napi::HandleScope scope(env);
+
+    try
+    {
+        if (info.Length() < 3 || !info[0].IsString() || !info[1].IsArray() || !info[2].IsArray())
+        {
+            Napi::TypeError::New(env, "Expected: trapdoor(string), encryptedMetadataList(array), edgeNodeIds(array)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
 
-    constructor = Napi::Persistent(func);
-    constructor.SuppressDestruct();
+        std::string trapdoor = info[0].As<Napi::String>();
+        auto encryptedMetadataList = std::make_shared<std::vector<std::string>>();
+        auto edgeNodeIds = std::make_shared<std::vector<std::string>>();
+        if (!ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", *encryptedMetadataList) ||
+            !ReadStringArray(env, info[2].As<Napi::Array>(), "Node array elements must be strings", *edgeNodeIds))
+        {
+            return env.Null();
+        }
 
-    exports.Set("CryptoEngine", func);
-    return exports;
+        // 可选的第四个参数：{signal, timeoutMs, demand}
+        double demand = 1.0;
+        if (info.Length() >= 4 && !ReadDemand(env, info[3], demand))
+        {
+            return env.Null();
+        }
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 4 && !link->Read(env, info[3]))
+        {
+            return env.Null();
+        }
+
+        auto allocation = std::make_shared<AllocationResult>();
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, trapdoor, encryptedMetadataList, edgeNodeIds, token, demand, allocation]()
+            {
+                *allocation = target->allocateResourcesAccordingToKeywords(trapdoor, *encryptedMetadataList, *edgeNodeIds, *token, demand);
+            },
+            [allocation](Napi::Env env) -> Napi::Value
+            {
+                Napi::Object result = NewBatchResult(env, allocation->status);
+                result.Set("nodeId", Napi::String::New(env, allocation->nodeId));
+                result.Set("evaluated", Napi::Number::New(env, static_cast<double>(allocation->evaluated)));
+                return result;
+            },
+            [link]() { link->Detach(); });
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
 }
 
-CryptoEngineWrapper::CryptoEngineWrapper(const Napi::CallbackInfo &info)
-    : Napi::ObjectWrap<CryptoEngineWrapper>(info)
+Napi::Value CryptoEngineWrapper::AllocateResourcesTopKAsync(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        // 创建CryptoEngine实例
-        engine = std::make_unique<CryptoEngineImpl>();
+        if (info.Length() < 4 || !info[0].IsString() || !info[1].IsArray() || !info[2].IsArray() || !info[3].IsNumber())
+        {
+            Napi::TypeError::New(env, "Expected: trapdoor(string), encryptedMetadataList(array), edgeNodeIds(array), k(number)").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        std::string trapdoor = info[0].As<Napi::String>();
+        auto encryptedMetadataList = std::make_shared<std::vector<std::string>>();
+        auto edgeNodeIds = std::make_shared<std::vector<std::string>>();
+        if (!ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", *encryptedMetadataList) ||
+            !ReadStringArray(env, info[2].As<Napi::Array>(), "Node array elements must be strings", *edgeNodeIds))
+        {
+            return env.Null();
+        }
+
+        int64_t k = info[3].As<Napi::Number>().Int64Value();
+        if (k < 1)
+        {
+            Napi::TypeError::New(env, "k must be a positive integer").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+
+        // 可选的第五个参数：{signal, timeoutMs, demand}
+        double demand = 1.0;
+        if (info.Length() >= 5 && !ReadDemand(env, info[4], demand))
+        {
+            return env.Null();
+        }
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 5 && !link->Read(env, info[4]))
+        {
+            return env.Null();
+        }
+
+        auto ranked = std::make_shared<RankedAllocationResult>();
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        size_t count = static_cast<size_t>(k);
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, trapdoor, encryptedMetadataList, edgeNodeIds, count, token, demand, ranked]()
+            {
+                *ranked = target->allocateTopK(trapdoor, *encryptedMetadataList, *edgeNodeIds, count, *token, demand);
+            },
+            [ranked](Napi::Env env) -> Napi::Value
+            {
+                Napi::Array nodeIds = Napi::Array::New(env, ranked->nodeIds.size());
+                for (size_t i = 0; i < ranked->nodeIds.size(); i++)
+                {
+                    nodeIds.Set(static_cast<uint32_t>(i), Napi::String::New(env, ranked->nodeIds[i]));
+                }
+                Napi::Object result = NewBatchResult(env, ranked->status);
+                result.Set("nodeIds", nodeIds);
+                result.Set("evaluated", Napi::Number::New(env, static_cast<double>(ranked->evaluated)));
+                return result;
+            },
+            [link]() { link->Detach(); });
     }
     catch (const std::exception &e)
     {
-        Napi::Error::New(env, "Failed to create CryptoEngine: " + std::string(e.what())).ThrowAsJavaScriptException();
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
     }
 }
 
-CryptoEngineWrapper::~CryptoEngineWrapper()
-{
-    // 析构函数自动处理engine的释放
-}
-
-Napi::Value CryptoEngineWrapper::SystemSetup(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::AllocateResourcesBatchAsync(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 1 || !info[0].IsNumber())
+        if (info.Length() < 3 || !info[0].IsArray() || !info[1].IsArray() || !info[2].IsArray())
         {
-            Napi::TypeError::New(env, "Number expected for securityLevel").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "Expected: trapdoors(array), encryptedMetadataList(array), edgeNodeIds(array)").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        int securityLevel = info[0].As<Napi::Number>().Int32Value();
-        bool result = engine->systemSetup(securityLevel);
+        auto trapdoors = std::make_shared<std::vector<std::string>>();
+        auto encryptedMetadataList = std::make_shared<std::vector<std::string>>();
+        auto edgeNodeIds = std::make_shared<std::vector<std::string>>();
+        if (!ReadStringArray(env, info[0].As<Napi::Array>(), "Trapdoor array elements must be strings", *trapdoors) ||
+            !ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", *encryptedMetadataList) ||
+            !ReadStringArray(env, info[2].As<Napi::Array>(), "Node array elements must be strings", *edgeNodeIds))
+        {
+            return env.Null();
+        }
 
-        return Napi::Boolean::New(env, result);
+        // 可选的第四个参数：{signal, timeoutMs, demand}
+        double demand = 1.0;
+        if (info.Length() >= 4 && !ReadDemand(env, info[3], demand))
+        {
+            return env.Null();
+        }
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 4 && !link->Read(env, info[3]))
+        {
+            return env.Null();
+        }
+
+        auto allocation = std::make_shared<BatchAllocationResult>();
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, trapdoors, encryptedMetadataList, edgeNodeIds, token, demand, allocation]()
+            {
+                *allocation = target->allocateBatch(*trapdoors, *encryptedMetadataList, *edgeNodeIds, *token, demand);
+            },
+            [allocation](Napi::Env env) -> Napi::Value
+            {
+                Napi::Array nodeIds = Napi::Array::New(env, allocation->nodeIds.size());
+                for (size_t i = 0; i < allocation->nodeIds.size(); i++)
+                {
+                    nodeIds.Set(static_cast<uint32_t>(i), Napi::String::New(env, allocation->nodeIds[i]));
+                }
+                Napi::Object result = NewBatchResult(env, allocation->status);
+                result.Set("nodeIds", nodeIds);
+                result.Set("complete", ToBooleanArray(env, allocation->complete));
+                return result;
+            },
+            [link]() { link->Detach(); });
     }
     catch (const std::exception &e)
     {
@@ -93,27 +1504,58 @@ Napi::Value CryptoEngineWrapper::SystemSetup(const Napi::CallbackInfo &info)
     }
 }
 
-Napi::Value CryptoEngineWrapper::NodeRegistration(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::MatchKeywordQueryAsync(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 1 || !info[0].IsString())
+        if (info.Length() < 2 || !info[1].IsArray())
         {
-            Napi::TypeError::New(env, "String expected for nodeId").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "Expected: query(string|object), encryptedMetadataList(array)").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string nodeId = info[0].As<Napi::String>();
-        auto result = engine->nodeRegistration(nodeId);
+        auto query = std::make_shared<KeywordQuery>();
+        auto trapdoors = std::make_shared<std::vector<std::string>>();
+        auto encryptedMetadataList = std::make_shared<std::vector<std::string>>();
+        if (!ReadKeywordQuery(env, info[0], *query, *trapdoors) ||
+            !ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", *encryptedMetadataList))
+        {
+            return env.Null();
+        }
 
-        Napi::Object obj = Napi::Object::New(env);
-        obj.Set("nodeId", Napi::String::New(env, result.first));
-        obj.Set("key", Napi::String::New(env, result.second));
+        // 可选的第三个参数：{signal, timeoutMs}
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 3 && !link->Read(env, info[2]))
+        {
+            return env.Null();
+        }
 
-        return obj;
+        auto results = std::make_shared<QueryMatchResult>();
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, query, trapdoors, encryptedMetadataList, token, results]()
+            {
+                *results = target->matchKeywordQuery(*query, *trapdoors, *encryptedMetadataList, *token);
+            },
+            [results](Napi::Env env) -> Napi::Value
+            {
+                // 未检查的条目为null
+                Napi::Array array = Napi::Array::New(env, results->matched.size());
+                for (size_t i = 0; i < results->matched.size(); i++)
+                {
+                    array.Set(static_cast<uint32_t>(i), results->evaluated[i] ? Napi::Boolean::New(env, results->matched[i]) : env.Null());
+                }
+                Napi::Object result = NewBatchResult(env, results->status);
+                result.Set("results", array);
+                result.Set("pairings", Napi::Number::New(env, static_cast<double>(results->pairings)));
+                return result;
+            },
+            [link]() { link->Detach(); });
     }
     catch (const std::exception &e)
     {
@@ -122,35 +1564,59 @@ Napi::Value CryptoEngineWrapper::NodeRegistration(const Napi::CallbackInfo &info
     }
 }
 
-Napi::Value CryptoEngineWrapper::GroupGeneration(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::AllocateResourcesByQueryAsync(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 1 || !info[0].IsArray())
+        if (info.Length() < 3 || !info[1].IsArray() || !info[2].IsArray())
         {
-            Napi::TypeError::New(env, "Array expected for nodeIds").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "Expected: query(string|object), encryptedMetadataList(array), edgeNodeIds(array)").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        Napi::Array nodeIdsArray = info[0].As<Napi::Array>();
-        std::vector<std::string> nodeIds;
+        auto query = std::make_shared<KeywordQuery>();
+        auto trapdoors = std::make_shared<std::vector<std::string>>();
+        auto encryptedMetadataList = std::make_shared<std::vector<std::string>>();
+        auto edgeNodeIds = std::make_shared<std::vector<std::string>>();
+        if (!ReadKeywordQuery(env, info[0], *query, *trapdoors) ||
+            !ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", *encryptedMetadataList) ||
+            !ReadStringArray(env, info[2].As<Napi::Array>(), "Node array elements must be strings", *edgeNodeIds))
+        {
+            return env.Null();
+        }
 
-        for (uint32_t i = 0; i < nodeIdsArray.Length(); i++)
+        // 可选的第四个参数：{signal, timeoutMs, demand}
+        double demand = 1.0;
+        if (info.Length() >= 4 && !ReadDemand(env, info[3], demand))
         {
-            Napi::Value value = nodeIdsArray[i];
-            if (!value.IsString())
-            {
-                Napi::TypeError::New(env, "Array elements must be strings").ThrowAsJavaScriptException();
-                return env.Null();
-            }
-            nodeIds.push_back(value.As<Napi::String>());
+            return env.Null();
+        }
+        auto link = std::make_shared<CancellationLink>();
+        if (info.Length() >= 4 && !link->Read(env, info[3]))
+        {
+            return env.Null();
         }
 
-        std::string result = engine->groupGeneration(nodeIds);
-        return Napi::String::New(env, result);
+        auto allocation = std::make_shared<AllocationResult>();
+        CryptoEngineImpl *target = engine.get();
+        std::shared_ptr<CancellationToken> token = link->token;
+        return RunAsPromise(
+            env, info.This().As<Napi::Object>(),
+            [target, query, trapdoors, encryptedMetadataList, edgeNodeIds, token, demand, allocation]()
+            {
+                *allocation = target->allocateByKeywordQuery(*query, *trapdoors, *encryptedMetadataList, *edgeNodeIds, *token, demand);
+            },
+            [allocation](Napi::Env env) -> Napi::Value
+            {
+                Napi::Object result = NewBatchResult(env, allocation->status);
+                result.Set("nodeId", Napi::String::New(env, allocation->nodeId));
+                result.Set("evaluated", Napi::Number::New(env, static_cast<double>(allocation->evaluated)));
+                return result;
+            },
+            [link]() { link->Detach(); });
     }
     catch (const std::exception &e)
     {
@@ -159,24 +1625,82 @@ Napi::Value CryptoEngineWrapper::GroupGeneration(const Napi::CallbackInfo &info)
     }
 }
 
-Napi::Value CryptoEngineWrapper::ResourceEncryption(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::AllocateResourcesStream(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        if (info.Length() < 4 || !info[0].IsString() || !info[1].IsArray() || !info[2].IsArray() || !info[3].IsFunction())
         {
-            Napi::TypeError::New(env, "String expected for plaintext and key").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "Expected: trapdoor(string), encryptedMetadataList(array), edgeNodeIds(array), onChunk(function)").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string plaintext = info[0].As<Napi::String>();
-        std::string key = info[1].As<Napi::String>();
+        std::string trapdoor = info[0].As<Napi::String>();
+        std::vector<std::string> encryptedMetadataList;
+        auto state = std::make_shared<MatchStreamState>(env);
+        if (!ReadStringArray(env, info[1].As<Napi::Array>(), "Metadata array elements must be strings", encryptedMetadataList) ||
+            !ReadStringArray(env, info[2].As<Napi::Array>(), "Node array elements must be strings", state->edgeNodeIds))
+        {
+            return env.Null();
+        }
+        Napi::Function onChunk = info[3].As<Napi::Function>();
 
-        std::string result = engine->resourceEncryption(plaintext, key);
-        return Napi::String::New(env, result);
+        // 可选的第五个参数：{signal, timeoutMs, maxPendingChunks}
+        size_t maxPendingChunks = 4;
+        if (info.Length() >= 5 && info[4].IsObject())
+        {
+            Napi::Value pending = info[4].As<Napi::Object>().Get("maxPendingChunks");
+            if (!pending.IsUndefined())
+            {
+                if (!pending.IsNumber() || pending.As<Napi::Number>().Int64Value() < 1)
+                {
+                    Napi::TypeError::New(env, "maxPendingChunks must be a positive integer").ThrowAsJavaScriptException();
+                    return env.Null();
+                }
+                maxPendingChunks = static_cast<size_t>(pending.As<Napi::Number>().Int64Value());
+            }
+        }
+        if (info.Length() >= 5 && !state->link.Read(env, info[4]))
+        {
+            return env.Null();
+        }
+
+        // MIRACL不支持多线程时在JS线程上扫描，各块直接回调
+        if (!CryptoEngineImpl::supportsBackgroundThreads())
+        {
+            try
+            {
+                state->result = engine->streamKeywordMatches(
+                    trapdoor, encryptedMetadataList,
+                    [env, onChunk, state](const std::vector<size_t> &indices)
+                    {
+                        DeliverMatchChunk(env, onChunk, new MatchStreamChunk{indices, state});
+                    },
+                    *state->link.token);
+            }
+            catch (const std::exception &e)
+            {
+                state->workerError = e.what();
+            }
+            Napi::Promise promise = state->deferred.Promise();
+            SettleMatchStream(env, *state);
+            return promise;
+        }
+
+        // 队列容量即未被JS消费的块数上限，超出时扫描在窗口边界暂停，只有本流式请求的后台线程等待
+        state->ownerRef = Napi::Persistent(info.This().As<Napi::Object>());
+        Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+            env, onChunk, "allocateResourcesStream", maxPendingChunks, 1,
+            [state](Napi::Env env) { SettleMatchStream(env, *state); });
+
+        Napi::Promise promise = state->deferred.Promise();
+        MatchStreamWorker *worker = new MatchStreamWorker(env, engine.get(), tsfn, state, trapdoor,
+                                                          std::move(encryptedMetadataList));
+        worker->Queue();
+        return promise;
     }
     catch (const std::exception &e)
     {
@@ -185,24 +1709,23 @@ Napi::Value CryptoEngineWrapper::ResourceEncryption(const Napi::CallbackInfo &in
     }
 }
 
-Napi::Value CryptoEngineWrapper::ResourceDecryption(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::ReleaseTrapdoor(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        if (info.Length() < 1 || !info[0].IsString())
         {
-            Napi::TypeError::New(env, "String expected for ciphertext and key").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "String expected for trapdoor").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string ciphertext = info[0].As<Napi::String>();
-        std::string key = info[1].As<Napi::String>();
+        std::string trapdoor = info[0].As<Napi::String>();
 
-        std::string result = engine->resourceDecryption(ciphertext, key);
-        return Napi::String::New(env, result);
+        bool result = engine->releaseTrapdoor(trapdoor);
+        return Napi::Boolean::New(env, result);
     }
     catch (const std::exception &e)
     {
@@ -211,24 +1734,23 @@ Napi::Value CryptoEngineWrapper::ResourceDecryption(const Napi::CallbackInfo &in
     }
 }
 
-Napi::Value CryptoEngineWrapper::SearchTokenGeneration(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::ReleaseEncapsulation(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        if (info.Length() < 1 || !info[0].IsString())
         {
-            Napi::TypeError::New(env, "String expected for keyword and key").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "String expected for encryptedMetadata").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string keyword = info[0].As<Napi::String>();
-        std::string key = info[1].As<Napi::String>();
+        std::string encryptedMetadata = info[0].As<Napi::String>();
 
-        std::string result = engine->searchTokenGeneration(keyword, key);
-        return Napi::String::New(env, result);
+        bool result = engine->releaseEncapsulation(encryptedMetadata);
+        return Napi::Boolean::New(env, result);
     }
     catch (const std::exception &e)
     {
@@ -237,43 +1759,41 @@ Napi::Value CryptoEngineWrapper::SearchTokenGeneration(const Napi::CallbackInfo
     }
 }
 
-Napi::Value CryptoEngineWrapper::Search(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::SetWorkerThreads(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray())
+        if (info.Length() < 1 || !info[0].IsNumber())
         {
-            Napi::TypeError::New(env, "String expected for token and Array for encryptedDocs").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "Number expected for worker thread count").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string token = info[0].As<Napi::String>();
-        Napi::Array docsArray = info[1].As<Napi::Array>();
-        std::vector<std::string> encryptedDocs;
+        int64_t count = info[0].As<Napi::Number>().Int64Value();
+        if (count < 0)
+        {
+            Napi::TypeError::New(env, "Worker thread count must not be negative").ThrowAsJavaScriptException();
+            return env.Null();
+        }
 
-        for (uint32_t i = 0; i < docsArray.Length(); i++)
+        // 可选的第二个参数：预留给交互请求的线程数
+        size_t reserved = static_cast<size_t>(-1);
+        if (info.Length() >= 2 && info[1].IsNumber())
         {
-            Napi::Value value = docsArray[i];
-            if (!value.IsString())
+            int64_t value = info[1].As<Napi::Number>().Int64Value();
+            if (value < 0)
             {
-                Napi::TypeError::New(env, "Array elements must be strings").ThrowAsJavaScriptException();
+                Napi::TypeError::New(env, "Reserved thread count must not be negative").ThrowAsJavaScriptException();
                 return env.Null();
             }
-            encryptedDocs.push_back(value.As<Napi::String>());
-        }
-
-        std::vector<std::string> results = engine->search(token, encryptedDocs);
-
-        Napi::Array resultArray = Napi::Array::New(env, results.size());
-        for (size_t i = 0; i < results.size(); i++)
-        {
-            resultArray[i] = Napi::String::New(env, results[i]);
+            reserved = static_cast<size_t>(value);
         }
 
-        return resultArray;
+        size_t applied = engine->setWorkerThreads(static_cast<size_t>(count), reserved);
+        return Napi::Number::New(env, static_cast<double>(applied));
     }
     catch (const std::exception &e)
     {
@@ -282,24 +1802,28 @@ Napi::Value CryptoEngineWrapper::Search(const Napi::CallbackInfo &info)
     }
 }
 
-Napi::Value CryptoEngineWrapper::VerifyKeywordMatch(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::SetAllocationPolicy(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        if (info.Length() < 1 || !info[0].IsString())
         {
-            Napi::TypeError::New(env, "String expected for trapdoor and encryptedMetadata").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "String expected for allocation policy").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string trapdoor = info[0].As<Napi::String>();
-        std::string encryptedMetadata = info[1].As<Napi::String>();
+        AllocationPolicyKind kind;
+        if (!parseAllocationPolicy(info[0].As<Napi::String>(), kind))
+        {
+            Napi::TypeError::New(env, "Unknown allocation policy").ThrowAsJavaScriptException();
+            return env.Null();
+        }
 
-        bool result = engine->verifyKeywordMatch(trapdoor, encryptedMetadata);
-        return Napi::Boolean::New(env, result);
+        engine->setAllocationPolicy(kind);
+        return Napi::String::New(env, allocationPolicyName(engine->allocationPolicy()));
     }
     catch (const std::exception &e)
     {
@@ -308,24 +1832,34 @@ Napi::Value CryptoEngineWrapper::VerifyKeywordMatch(const Napi::CallbackInfo &in
     }
 }
 
-Napi::Value CryptoEngineWrapper::EncapsulateKeyword(const Napi::CallbackInfo &info)
+Napi::Value CryptoEngineWrapper::SetDerivedNodeKeys(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString())
+        if (info.Length() < 1 || !info[0].IsBoolean())
         {
-            Napi::TypeError::New(env, "String expected for keyword and metadata").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "Boolean expected for derived key mode").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string keyword = info[0].As<Napi::String>();
-        std::string metadata = info[1].As<Napi::String>();
+        // 可选的第二个参数：热缓存容量(节点数)
+        size_t capacity = NodeKeyCache::DEFAULT_CAPACITY;
+        if (info.Length() >= 2 && info[1].IsNumber())
+        {
+            int64_t value = info[1].As<Napi::Number>().Int64Value();
+            if (value <= 0)
+            {
+                Napi::TypeError::New(env, "Key cache capacity must be positive").ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            capacity = static_cast<size_t>(value);
+        }
 
-        std::string result = engine->encapsulateKeyword(keyword, metadata);
-        return Napi::String::New(env, result);
+        bool enabled = engine->setDerivedNodeKeys(info[0].As<Napi::Boolean>().Value(), capacity);
+        return Napi::Boolean::New(env, enabled);
     }
     catch (const std::exception &e)
     {
@@ -334,49 +1868,75 @@ Napi::Value CryptoEngineWrapper::EncapsulateKeyword(const Napi::CallbackInfo &in
     }
 }
 
-Napi::Value CryptoEngineWrapper::AllocateResourcesAccordingToKeywords(const Napi::CallbackInfo &info)
+// 读取JS数值数组，元素类型不符时抛出TypeError并返回false
+static bool ReadNumberArray(Napi::Env env, const Napi::Array &array, const char *message, std::vector<double> &out)
+{
+    out.clear();
+    out.reserve(array.Length());
+    for (uint32_t i = 0; i < array.Length(); i++)
+    {
+        Napi::Value value = array[i];
+        if (!value.IsNumber())
+        {
+            Napi::TypeError::New(env, message).ThrowAsJavaScriptException();
+            return false;
+        }
+        out.push_back(value.As<Napi::Number>().DoubleValue());
+    }
+    return true;
+}
+
+Napi::Value CryptoEngineWrapper::UpdateNodeLoads(const Napi::CallbackInfo &info)
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
     try
     {
-        if (info.Length() < 3 || !info[0].IsString() || !info[1].IsArray() || !info[2].IsArray())
+        if (info.Length() < 3 || !info[0].IsArray() || !info[1].IsArray() || !info[2].IsArray())
         {
-            Napi::TypeError::New(env, "Expected: trapdoor(string), encryptedMetadataList(array), edgeNodeIds(array)").ThrowAsJavaScriptException();
+            Napi::TypeError::New(env, "Expected: nodeIds(array), loads(array), capacities(array), [weights(array)]").ThrowAsJavaScriptException();
             return env.Null();
         }
 
-        std::string trapdoor = info[0].As<Napi::String>();
-
-        Napi::Array metadataArray = info[1].As<Napi::Array>();
-        std::vector<std::string> encryptedMetadataList;
-        for (uint32_t i = 0; i < metadataArray.Length(); i++)
+        std::vector<std::string> nodeIds;
+        std::vector<double> loads;
+        std::vector<double> capacities;
+        std::vector<double> weights;
+        if (!ReadStringArray(env, info[0].As<Napi::Array>(), "Node array elements must be strings", nodeIds) ||
+            !ReadNumberArray(env, info[1].As<Napi::Array>(), "Load array elements must be numbers", loads) ||
+            !ReadNumberArray(env, info[2].As<Napi::Array>(), "Capacity array elements must be numbers", capacities))
         {
-            Napi::Value value = metadataArray[i];
-            if (!value.IsString())
+            return env.Null();
+        }
+        // 可选的第四个参数：权重，缺省为1
+        if (info.Length() >= 4 && info[3].IsArray())
+        {
+            if (!ReadNumberArray(env, info[3].As<Napi::Array>(), "Weight array elements must be numbers", weights))
             {
-                Napi::TypeError::New(env, "Metadata array elements must be strings").ThrowAsJavaScriptException();
                 return env.Null();
             }
-            encryptedMetadataList.push_back(value.As<Napi::String>());
+        }
+        else
+        {
+            weights.assign(nodeIds.size(), 1.0);
         }
 
-        Napi::Array nodesArray = info[2].As<Napi::Array>();
-        std::vector<std::string> edgeNodeIds;
-        for (uint32_t i = 0; i < nodesArray.Length(); i++)
+        if (loads.size() != nodeIds.size() || capacities.size() != nodeIds.size() || weights.size() != nodeIds.size())
         {
-            Napi::Value value = nodesArray[i];
-            if (!value.IsString())
-            {
-                Napi::TypeError::New(env, "Node array elements must be strings").ThrowAsJavaScriptException();
-                return env.Null();
-            }
-            edgeNodeIds.push_back(value.As<Napi::String>());
+            Napi::TypeError::New(env, "Node, load, capacity and weight arrays must have the same length").ThrowAsJavaScriptException();
+            return env.Null();
         }
 
-        std::string result = engine->allocateResourcesAccordingToKeywords(trapdoor, encryptedMetadataList, edgeNodeIds);
-        return Napi::String::New(env, result);
+        std::vector<NodeLoadInfo> infos(nodeIds.size());
+        for (size_t i = 0; i < nodeIds.size(); i++)
+        {
+            infos[i].load = loads[i];
+            infos[i].capacity = capacities[i];
+            infos[i].weight = weights[i];
+        }
+        engine->updateNodeLoads(nodeIds, infos);
+        return env.Undefined();
     }
     catch (const std::exception &e)
     {
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "striped_lru_cache.h"
+
+struct NodeRecord;
+
+/**
+ * @brief 派生密钥模式下的节点密钥热缓存
+ *
+ * 以节点ID为键缓存按需重新计算出的节点密钥材料，容量有界，按LRU淘汰。
+ */
+class NodeKeyCache : public StripedLruCache<std::string, std::shared_ptr<const NodeRecord>>
+{
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 14;
+
+    /**
+     * @brief 构造函数
+     * @param capacity 最多缓存的节点数
+     */
+    explicit NodeKeyCache(size_t capacity = DEFAULT_CAPACITY) : StripedLruCache(capacity) {}
+};
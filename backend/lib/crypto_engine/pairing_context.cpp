@@ -0,0 +1,35 @@
+#include "pairing_context.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+PFC &threadPfc()
+{
+    thread_local unique_ptr<PFC> pfc;
+
+    if (!pfc)
+    {
+        pfc.reset(new PFC(AES_SECURITY));
+
+        // 每个线程的随机数生成器独立播种，避免各线程产生相同的随机序列
+        random_device rd;
+        long seed = static_cast<long>(rd()) ^
+                    static_cast<long>(chrono::steady_clock::now().time_since_epoch().count()) ^
+                    static_cast<long>(hash<thread::id>()(this_thread::get_id()));
+        irand(seed);
+    }
+    return *pfc;
+}
+
+void hashStringToG1(PFC &pfc, const string &input, G1 &out)
+{
+    // hash_and_map需要可写的C字符串
+    vector<char> buffer(input.begin(), input.end());
+    buffer.push_back('\0');
+    pfc.hash_and_map(out, buffer.data());
+}
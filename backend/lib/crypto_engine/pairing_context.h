@@ -0,0 +1,56 @@
+#pragma once
+
+#ifdef compare
+#undef compare
+#endif
+
+#include <string>
+
+#ifndef MR_PAIRING_SS2
+#define MR_PAIRING_SS2   // 使用SS2类型的配对
+#endif
+#ifndef AES_SECURITY
+#define AES_SECURITY 128 // AES-128安全级别
+#endif
+
+#include "../../../libs/miracl/include/mirdef.h"
+#include "../../../libs/miracl/include/miracl.h"
+#include "../../../libs/miracl/include/big.h"
+#include "../../../libs/miracl/include/ec2.h"
+#include "../../../libs/miracl/include/gf2m.h"
+#include "../../../libs/miracl/include/pairing_1.h"
+
+#undef compare
+#undef mr_compare
+
+// MIRACL以多线程方式编译时(mirdef.h中定义了MR_WINDOWS_MT/MR_UNIX_MT/MR_OPENMP_MT)，
+// 每个线程拥有独立的miracl实例，引擎才能在工作线程上并行执行密码学运算
+#if defined(MR_WINDOWS_MT) || defined(MR_UNIX_MT) || defined(MR_OPENMP_MT)
+#define CRYPTO_ENGINE_MIRACL_MT 1
+#else
+#define CRYPTO_ENGINE_MIRACL_MT 0
+#endif
+
+/**
+ * @brief 获取当前线程的配对上下文
+ *
+ * PFC在构造时会创建miracl实例，同一线程只能持有一个。引擎中所有密码学运算
+ * 都通过本函数取得当前线程的PFC，首次调用时创建并为该线程的随机数生成器播种。
+ */
+PFC &threadPfc();
+
+/**
+ * @brief 当前MIRACL构建是否支持在多个线程上并行运算
+ */
+inline bool miraclSupportsThreads()
+{
+    return CRYPTO_ENGINE_MIRACL_MT != 0;
+}
+
+/**
+ * @brief 将字符串哈希映射到G1群 (H1/H2)
+ * @param pfc 当前线程的配对上下文
+ * @param input 待哈希的字符串
+ * @param out 输出的G1元素
+ */
+void hashStringToG1(PFC &pfc, const std::string &input, G1 &out);
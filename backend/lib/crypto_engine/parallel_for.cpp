@@ -0,0 +1,9 @@
+#include "parallel_for.h"
+#include "task_scheduler.h"
+
+using namespace std;
+
+void parallelFor(size_t count, size_t grain, const function<void(size_t begin, size_t end)> &body)
+{
+    TaskScheduler::instance().parallelFor(count, grain, body);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief 将区间[0, count)切分为若干块并在多个线程上并行执行
+ *
+ * 各块提交到引擎共享的TaskScheduler执行，调用线程也参与执行，函数在所有块
+ * 完成后返回；任一块抛出的异常会在调用线程中重新抛出。MIRACL未以多线程方式
+ * 编译时退化为串行执行。
+ *
+ * @param count 元素总数
+ * @param grain 每块的最小元素数
+ * @param body 处理区间[begin, end)的函数
+ */
+void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)> &body);
@@ -0,0 +1,273 @@
+#include "point_accumulator.h"
+#include <atomic>
+
+using namespace std;
+
+namespace
+{
+    // 是否启用射影累加(自检通过后置为true)
+    atomic<bool> projectiveEnabled(false);
+
+    // 曲线系数a(取0或1)，系数c固定为1，即 y^2 + y = x^3 + a*x + b
+    atomic<int> curveA(1);
+
+    bool toAffineCoords(const G1 &point, GF2m &x, GF2m &y)
+    {
+        if (point.g.iszero())
+        {
+            return false;
+        }
+        Big bx, by;
+        point.g.get(bx, by);
+        x = GF2m(bx);
+        y = GF2m(by);
+        return true;
+    }
+
+    G1 fromAffineCoords(const GF2m &x, const GF2m &y)
+    {
+        G1 point;
+        point.g.set(Big(x.getbig()), Big(y.getbig()));
+        return point;
+    }
+}
+
+PointAccumulator::PointAccumulator() : X(0), Y(1), Z(0), infinity(true)
+{
+}
+
+void PointAccumulator::add(const G1 &point)
+{
+    if (!projectiveEnabled.load(memory_order_relaxed))
+    {
+        if (infinity)
+        {
+            affineSum = point;
+            infinity = false;
+        }
+        else
+        {
+            affineSum = affineSum + point;
+        }
+        return;
+    }
+
+    GF2m x2, y2;
+    if (!toAffineCoords(point, x2, y2))
+    {
+        return;
+    }
+    addAffine(x2, y2);
+}
+
+void PointAccumulator::add(const PointAccumulator &other)
+{
+    if (other.infinity)
+    {
+        return;
+    }
+
+    if (!projectiveEnabled.load(memory_order_relaxed))
+    {
+        add(other.affineSum);
+        return;
+    }
+
+    if (infinity)
+    {
+        X = other.X;
+        Y = other.Y;
+        Z = other.Z;
+        infinity = false;
+        return;
+    }
+    addProjective(other.X, other.Y, other.Z);
+}
+
+G1 PointAccumulator::toAffine() const
+{
+    if (infinity)
+    {
+        return G1();
+    }
+    if (!projectiveEnabled.load(memory_order_relaxed))
+    {
+        return affineSum;
+    }
+
+    GF2m zInv = inverse(Z);
+    return fromAffineCoords(X * zInv, Y * zInv);
+}
+
+void PointAccumulator::toAffineBatch(const vector<PointAccumulator> &points, vector<G1> &out)
+{
+    out.assign(points.size(), G1());
+    if (!projectiveEnabled.load(memory_order_relaxed))
+    {
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            out[i] = points[i].toAffine();
+        }
+        return;
+    }
+
+    // prefix[k] = Z_0 * Z_1 * ... * Z_k(仅统计非无穷远点)
+    vector<size_t> indices;
+    vector<GF2m> prefix;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        if (points[i].infinity)
+        {
+            continue;
+        }
+        indices.push_back(i);
+        prefix.push_back(prefix.empty() ? points[i].Z : prefix.back() * points[i].Z);
+    }
+    if (indices.empty())
+    {
+        return;
+    }
+
+    // 只求一次逆，再从后向前依次剥离各点的Z
+    GF2m inv = inverse(prefix.back());
+    for (size_t k = indices.size(); k-- > 0;)
+    {
+        const PointAccumulator &p = points[indices[k]];
+        GF2m zInv = (k == 0) ? inv : inv * prefix[k - 1];
+        inv = inv * p.Z;
+        out[indices[k]] = fromAffineCoords(p.X * zInv, p.Y * zInv);
+    }
+}
+
+bool PointAccumulator::detectCurveModel(PFC &pfc)
+{
+    G1 p, q;
+    pfc.random(p);
+    pfc.random(q);
+    G1 sum = p + q;
+    G1 doubled = p + p;
+    G1 mixed = sum + p;
+
+    // 依次尝试 a = 1 与 a = 0，以MIRACL的仿射加法结果为准
+    const int candidates[] = {1, 0};
+    for (int a : candidates)
+    {
+        curveA.store(a, memory_order_relaxed);
+        projectiveEnabled.store(true, memory_order_relaxed);
+
+        PointAccumulator accSum, accDouble, accOther;
+        accSum.add(p);
+        accSum.add(q);
+        // 加上同一点时走倍点公式
+        accDouble.add(p);
+        accDouble.add(p);
+        accOther.add(p);
+        accOther.add(accSum);
+
+        vector<PointAccumulator> batch;
+        batch.push_back(accSum);
+        batch.push_back(accDouble);
+        batch.push_back(accOther);
+        vector<G1> affine;
+        toAffineBatch(batch, affine);
+
+        if (accSum.toAffine() == sum && affine[0] == sum && affine[1] == doubled && affine[2] == mixed)
+        {
+            return true;
+        }
+    }
+
+    projectiveEnabled.store(false, memory_order_relaxed);
+    return false;
+}
+
+void PointAccumulator::addAffine(const GF2m &x2, const GF2m &y2)
+{
+    if (infinity)
+    {
+        X = x2;
+        Y = y2;
+        Z = GF2m(1);
+        infinity = false;
+        return;
+    }
+
+    // λ = A/B，A = Z(y1 + y2)，B = Z(x1 + x2)
+    GF2m A = Y + y2 * Z;
+    GF2m B = X + x2 * Z;
+    if (B.iszero())
+    {
+        // 同一点则倍点，互为相反点则和为无穷远点
+        if (A.iszero())
+        {
+            doubleOnce();
+        }
+        else
+        {
+            infinity = true;
+        }
+        return;
+    }
+
+    GF2m B2 = B * B;
+    GF2m B3 = B2 * B;
+    GF2m C = A * A * Z + B3;
+
+    GF2m newY = A * (X * B2 + C) + (Y + Z) * B3;
+    X = C * B;
+    Z = B3 * Z;
+    Y = newY;
+}
+
+void PointAccumulator::addProjective(const GF2m &X2, const GF2m &Y2, const GF2m &Z2)
+{
+    GF2m A = Y * Z2 + Y2 * Z;
+    GF2m B = X * Z2 + X2 * Z;
+    if (B.iszero())
+    {
+        if (A.iszero())
+        {
+            doubleOnce();
+        }
+        else
+        {
+            infinity = true;
+        }
+        return;
+    }
+
+    GF2m Z12 = Z * Z2;
+    GF2m B2 = B * B;
+    GF2m B3 = B2 * B;
+    GF2m C = A * A * Z12 + B3;
+
+    GF2m newY = A * (X * Z2 * B2 + C) + (Y + Z) * Z2 * B3;
+    X = C * B;
+    Z = B3 * Z12;
+    Y = newY;
+}
+
+void PointAccumulator::doubleOnce()
+{
+    if (infinity)
+    {
+        return;
+    }
+
+    // λ = (x^2 + a)/c = D/E，D = X^2 + a*Z^2，E = Z^2 (c = 1)
+    GF2m E = Z * Z;
+    GF2m D = X * X;
+    if (curveA.load(memory_order_relaxed) == 1)
+    {
+        D += E;
+    }
+
+    GF2m E2 = E * E;
+    GF2m E3 = E2 * E;
+    GF2m D2 = D * D;
+
+    GF2m newY = D * X * E2 + D2 * D * Z + (Y + Z) * E3;
+    X = D2 * E * Z;
+    Z = E3 * Z;
+    Y = newY;
+}
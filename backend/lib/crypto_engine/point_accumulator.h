@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "pairing_context.h"
+
+/**
+ * @brief G1点的射影坐标累加器
+ *
+ * SS2配对使用GF(2^m)上的超奇异曲线 y^2 + y = x^3 + a*x + b。仿射坐标下每次点加
+ * 都需要一次域求逆，而求逆是最昂贵的域运算。累加器以齐次射影坐标(x = X/Z,
+ * y = Y/Z)保存中间结果，加法与倍点只做域乘法，最终转回仿射坐标时才求逆一次；
+ * 多个累加器还可通过Montgomery技巧共用一次求逆批量归一化。
+ *
+ * 曲线系数在systemSetup时由detectCurveModel自检确定；自检未通过时累加器
+ * 退化为直接使用G1加法，结果不受影响。
+ */
+class PointAccumulator
+{
+public:
+    PointAccumulator();
+
+    /**
+     * @brief 加上一个仿射点(混合加法)
+     */
+    void add(const G1 &point);
+
+    /**
+     * @brief 加上另一个累加器(射影加法)
+     */
+    void add(const PointAccumulator &other);
+
+    /**
+     * @brief 是否为无穷远点
+     */
+    bool isInfinity() const { return infinity; }
+
+    /**
+     * @brief 转换为仿射坐标的G1点(一次求逆)
+     */
+    G1 toAffine() const;
+
+    /**
+     * @brief 批量转换为仿射坐标，所有点共用一次求逆(Montgomery技巧)
+     *
+     * 用于一次产生多个射影累加结果的场合(群组成员树各层的部分和)。封装时的 X = y*P 由MIRACL的
+     * 标量乘法直接给出仿射点，不经过累加器，也不序列化，因此批量封装不使用本函数。
+     * @param points 待转换的累加器
+     * @param out 输出的G1点，与输入一一对应
+     */
+    static void toAffineBatch(const std::vector<PointAccumulator> &points, std::vector<G1> &out);
+
+    /**
+     * @brief 用随机点自检射影公式，确定曲线系数并启用射影累加
+     * @param pfc 当前线程的配对上下文
+     * @return 是否启用了射影累加
+     */
+    static bool detectCurveModel(PFC &pfc);
+
+private:
+    GF2m X, Y, Z;
+    bool infinity;
+
+    // 自检未通过时使用的仿射累加结果
+    G1 affineSum;
+
+    void addAffine(const GF2m &x2, const GF2m &y2);
+    void addProjective(const GF2m &X2, const GF2m &Y2, const GF2m &Z2);
+    void doubleOnce();
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 分段加锁、容量有界的LRU缓存
+ *
+ * 用于按需重新计算、只需保留近期热点的缓存(派生的节点密钥、关键词的GT底数等)。
+ * 键按哈希分到STRIPES个独立加锁的分段，每个分段各自按LRU淘汰，容量为总容量的1/STRIPES。
+ * 可设置淘汰回调，用于同步清除依附于被淘汰条目的其他缓存；回调在释放分段锁之后调用。
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+class StripedLruCache
+{
+public:
+    static const size_t STRIPES = 16;
+
+    // 淘汰回调，参数为因超出容量而被淘汰的键值(显式erase与clear不触发)
+    typedef std::function<void(const K &, const V &)> EvictionHook;
+
+    /**
+     * @brief 构造函数
+     * @param capacity 所有分段合计最多缓存的条目数
+     * @param onEvict 淘汰回调，可为空
+     */
+    explicit StripedLruCache(size_t capacity, EvictionHook onEvict = EvictionHook()) : onEvict_(std::move(onEvict))
+    {
+        setCapacity(capacity);
+    }
+
+    /**
+     * @brief 查询键，命中时将值复制到out并移到最近使用
+     */
+    bool find(const K &key, V &out)
+    {
+        Stripe &stripe = stripeOf(key);
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        auto it = stripe.index.find(key);
+        if (it == stripe.index.end())
+        {
+            return false;
+        }
+
+        // 命中后移到表头
+        stripe.entries.splice(stripe.entries.begin(), stripe.entries, it->second);
+        out = it->second->second;
+        return true;
+    }
+
+    /**
+     * @brief 键是否存在(不改变LRU顺序)
+     */
+    bool contains(const K &key) const
+    {
+        const Stripe &stripe = stripes_[Hash()(key) % STRIPES];
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        return stripe.index.find(key) != stripe.index.end();
+    }
+
+    /**
+     * @brief 写入键值，已存在时覆盖；超出容量时淘汰所在分段最久未使用的条目
+     */
+    void insert(const K &key, const V &value)
+    {
+        std::vector<Entry> evicted;
+        {
+            Stripe &stripe = stripeOf(key);
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            auto it = stripe.index.find(key);
+            if (it != stripe.index.end())
+            {
+                it->second->second = value;
+                stripe.entries.splice(stripe.entries.begin(), stripe.entries, it->second);
+                return;
+            }
+
+            stripe.entries.push_front(std::make_pair(key, value));
+            stripe.index[key] = stripe.entries.begin();
+            evict(stripe, evicted);
+        }
+        notify(evicted);
+    }
+
+    /**
+     * @brief 删除键
+     * @return 键是否存在
+     */
+    bool erase(const K &key)
+    {
+        Stripe &stripe = stripeOf(key);
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        auto it = stripe.index.find(key);
+        if (it == stripe.index.end())
+        {
+            return false;
+        }
+        stripe.entries.erase(it->second);
+        stripe.index.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief 清空缓存
+     */
+    void clear()
+    {
+        for (auto &stripe : stripes_)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            stripe.entries.clear();
+            stripe.index.clear();
+        }
+    }
+
+    /**
+     * @brief 调整总容量，超出新容量的条目立即淘汰
+     */
+    void setCapacity(size_t capacity)
+    {
+        size_t perStripe = (capacity + STRIPES - 1) / STRIPES;
+        std::vector<Entry> evicted;
+        for (auto &stripe : stripes_)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            stripe.capacity = perStripe > 0 ? perStripe : 1;
+            evict(stripe, evicted);
+        }
+        notify(evicted);
+    }
+
+    /**
+     * @brief 当前缓存的条目数(各分段依次统计，并发写入时为近似值)
+     */
+    size_t size() const
+    {
+        size_t total = 0;
+        for (const auto &stripe : stripes_)
+        {
+            std::lock_guard<std::mutex> lock(stripe.mtx);
+            total += stripe.entries.size();
+        }
+        return total;
+    }
+
+private:
+    typedef std::pair<K, V> Entry;
+
+    struct Stripe
+    {
+        mutable std::mutex mtx;
+        size_t capacity = 1;
+        std::list<Entry> entries; // 表头为最近使用
+        std::unordered_map<K, typename std::list<Entry>::iterator, Hash> index;
+    };
+
+    Stripe &stripeOf(const K &key)
+    {
+        return stripes_[Hash()(key) % STRIPES];
+    }
+
+    // 超出容量时淘汰表尾，被淘汰的条目移入evicted(调用方须持有分段的锁)
+    void evict(Stripe &stripe, std::vector<Entry> &evicted)
+    {
+        while (stripe.entries.size() > stripe.capacity)
+        {
+            stripe.index.erase(stripe.entries.back().first);
+            if (onEvict_)
+            {
+                evicted.push_back(std::move(stripe.entries.back()));
+            }
+            stripe.entries.pop_back();
+        }
+    }
+
+    // 在分段锁之外调用淘汰回调
+    void notify(const std::vector<Entry> &evicted)
+    {
+        for (const Entry &entry : evicted)
+        {
+            onEvict_(entry.first, entry.second);
+        }
+    }
+
+    EvictionHook onEvict_;
+    Stripe stripes_[STRIPES];
+};
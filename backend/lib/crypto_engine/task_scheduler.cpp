@@ -0,0 +1,503 @@
+#include "task_scheduler.h"
+#include "pairing_context.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+    const size_t NO_WORKER = static_cast<size_t>(-1);
+
+    // 当前线程所属的调度器及其工作线程下标(外部线程为NO_WORKER)
+    thread_local TaskScheduler *currentScheduler = nullptr;
+    thread_local size_t currentWorker = NO_WORKER;
+
+    // 当前线程提交任务时使用的优先级
+    thread_local TaskPriority threadPriority = TaskPriority::Interactive;
+
+    void runTask(const TaskScheduler::Task &task, TaskPriority priority)
+    {
+        TaskPriority previous = threadPriority;
+        threadPriority = priority;
+        try
+        {
+            task();
+        }
+        catch (const exception &e)
+        {
+            cerr << "调度任务执行失败: " << e.what() << endl;
+        }
+        catch (...)
+        {
+            cerr << "调度任务执行失败: 未知异常" << endl;
+        }
+        threadPriority = previous;
+    }
+
+    // 预留线程数：自动时取总数的1/4，至少1个，且至少留1个线程执行批量任务
+    size_t resolveReserved(size_t count, size_t reserved)
+    {
+        if (count < 2)
+        {
+            return 0;
+        }
+        if (reserved == TaskScheduler::AUTO_RESERVED)
+        {
+            reserved = max<size_t>(1, count / 4);
+        }
+        return min(reserved, count - 1);
+    }
+}
+
+ScopedTaskPriority::ScopedTaskPriority(TaskPriority priority) : previous_(threadPriority)
+{
+    threadPriority = priority;
+}
+
+ScopedTaskPriority::~ScopedTaskPriority()
+{
+    threadPriority = previous_;
+}
+
+TaskScheduler &TaskScheduler::instance()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskScheduler::TaskScheduler()
+    : activeWorkers_(0), reservedWorkers_(0), queued_(0), interactiveQueued_(0), stopping_(false)
+{
+    size_t count = defaultWorkerCount();
+    startWorkers(count, resolveReserved(count, AUTO_RESERVED));
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    lock_guard<mutex> control(controlMtx_);
+    vector<QueuedTask> leftover;
+    stopWorkers(leftover);
+}
+
+size_t TaskScheduler::defaultWorkerCount()
+{
+    if (!miraclSupportsThreads())
+    {
+        return 0;
+    }
+    size_t hardware = max<size_t>(1, thread::hardware_concurrency());
+    return hardware - 1;
+}
+
+TaskPriority TaskScheduler::currentPriority()
+{
+    return threadPriority;
+}
+
+size_t TaskScheduler::setWorkerCount(size_t count, size_t reservedInteractive)
+{
+    if (count > 0 && !miraclSupportsThreads())
+    {
+        cerr << "警告: MIRACL未以多线程方式编译，任务将在调用线程上串行执行" << endl;
+        count = 0;
+    }
+
+    lock_guard<mutex> control(controlMtx_);
+    vector<QueuedTask> leftover;
+    stopWorkers(leftover);
+    startWorkers(count, resolveReserved(count, reservedInteractive));
+
+    // 尚未执行的任务交给新的工作线程，没有工作线程时就地执行
+    for (auto &queued : leftover)
+    {
+        if (count == 0)
+        {
+            runTask(queued.task, queued.priority);
+        }
+        else
+        {
+            enqueue(move(queued));
+        }
+    }
+    return count;
+}
+
+void TaskScheduler::submit(Task task)
+{
+    submit(move(task), threadPriority);
+}
+
+void TaskScheduler::submit(Task task, TaskPriority priority)
+{
+    if (priority == TaskPriority::Bulk && currentScheduler == this && currentWorker != NO_WORKER)
+    {
+        // 工作线程提交的批量任务压入自己的队列
+        Worker &self = *workers_[currentWorker];
+        {
+            lock_guard<mutex> lock(self.mtx);
+            self.tasks.push_back(move(task));
+        }
+        notifyQueued(priority);
+        return;
+    }
+
+    bool queued = false;
+    {
+        lock_guard<mutex> lock(globalMtx_);
+        if (activeWorkers_.load() > 0)
+        {
+            if (priority == TaskPriority::Interactive)
+            {
+                lock_guard<mutex> interactiveLock(interactiveMtx_);
+                interactiveTasks_.push_back(move(task));
+            }
+            else
+            {
+                globalTasks_.push_back(move(task));
+            }
+            queued = true;
+        }
+    }
+
+    if (!queued)
+    {
+        // 没有工作线程，直接在当前线程执行
+        runTask(task, priority);
+        return;
+    }
+    notifyQueued(priority);
+}
+
+void TaskScheduler::yieldToInteractive()
+{
+    if (currentScheduler != this || currentWorker == NO_WORKER)
+    {
+        return;
+    }
+
+    QueuedTask queued;
+    while (popInteractive(queued))
+    {
+        runTask(queued.task, queued.priority);
+    }
+}
+
+void TaskScheduler::parallelFor(size_t count, size_t grain, const function<void(size_t begin, size_t end)> &body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (grain == 0)
+    {
+        grain = 1;
+    }
+
+    // 批量任务不使用预留线程
+    TaskPriority priority = threadPriority;
+    size_t available = activeWorkers_.load();
+    if (priority == TaskPriority::Bulk)
+    {
+        size_t reserved = reservedWorkers_.load();
+        available = available > reserved ? available - reserved : 0;
+    }
+
+    size_t chunks = (count + grain - 1) / grain;
+    size_t helpers = min(chunks - 1, available);
+    if (helpers == 0)
+    {
+        body(0, count);
+        return;
+    }
+
+    // 任务对象由调用线程与各协助任务共享，协助任务可能晚于本函数返回才被执行
+    struct Job
+    {
+        atomic<size_t> nextChunk{0};
+        atomic<size_t> inFlight{0};
+        mutex mtx;
+        condition_variable done;
+        exception_ptr firstError;
+    };
+    shared_ptr<Job> job = make_shared<Job>();
+    const function<void(size_t, size_t)> *bodyPtr = &body;
+    TaskScheduler *scheduler = this;
+
+    // 各参与者通过原子计数器领取下一块；先登记再领取，领不到块的参与者不会访问body
+    auto runChunks = [job, bodyPtr, count, grain, chunks, priority, scheduler]()
+    {
+        job->inFlight.fetch_add(1);
+        for (;;)
+        {
+            // 批量任务在块之间让出给等待中的交互任务
+            if (priority == TaskPriority::Bulk)
+            {
+                scheduler->yieldToInteractive();
+            }
+
+            size_t chunk = job->nextChunk.fetch_add(1);
+            if (chunk >= chunks)
+            {
+                break;
+            }
+            size_t begin = chunk * grain;
+            size_t end = min(count, begin + grain);
+            try
+            {
+                (*bodyPtr)(begin, end);
+            }
+            catch (...)
+            {
+                lock_guard<mutex> lock(job->mtx);
+                if (!job->firstError)
+                {
+                    job->firstError = current_exception();
+                }
+                // 出错后放弃剩余的块
+                job->nextChunk.store(chunks);
+            }
+        }
+        if (job->inFlight.fetch_sub(1) == 1)
+        {
+            lock_guard<mutex> lock(job->mtx);
+            job->done.notify_all();
+        }
+    };
+
+    for (size_t i = 0; i < helpers; i++)
+    {
+        submit(runChunks, priority);
+    }
+    runChunks();
+
+    // 所有块都已被领取，只需等待仍在执行的块
+    {
+        unique_lock<mutex> lock(job->mtx);
+        job->done.wait(lock, [&]() { return job->inFlight.load() == 0; });
+    }
+
+    if (job->firstError)
+    {
+        rethrow_exception(job->firstError);
+    }
+}
+
+void TaskScheduler::startWorkers(size_t count, size_t reserved)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        workers_.emplace_back(new Worker());
+        workers_[i]->reserved = i < reserved;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        workers_[i]->thread = thread(&TaskScheduler::workerLoop, this, i);
+    }
+
+    lock_guard<mutex> lock(globalMtx_);
+    reservedWorkers_.store(reserved);
+    activeWorkers_.store(count);
+}
+
+void TaskScheduler::stopWorkers(vector<QueuedTask> &leftover)
+{
+    // 此后外部提交的任务直接在提交线程上执行
+    {
+        lock_guard<mutex> lock(globalMtx_);
+        activeWorkers_.store(0);
+        reservedWorkers_.store(0);
+    }
+
+    {
+        lock_guard<mutex> lock(sleepMtx_);
+        stopping_ = true;
+    }
+    wakeGeneral_.notify_all();
+    wakeReserved_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+
+    // 收集尚未执行的任务，交互任务排在前面
+    {
+        lock_guard<mutex> lock(interactiveMtx_);
+        for (auto &task : interactiveTasks_)
+        {
+            leftover.push_back(QueuedTask{move(task), TaskPriority::Interactive});
+        }
+        interactiveTasks_.clear();
+    }
+    for (auto &worker : workers_)
+    {
+        for (auto &task : worker->tasks)
+        {
+            leftover.push_back(QueuedTask{move(task), TaskPriority::Bulk});
+        }
+    }
+    workers_.clear();
+    {
+        lock_guard<mutex> lock(globalMtx_);
+        for (auto &task : globalTasks_)
+        {
+            leftover.push_back(QueuedTask{move(task), TaskPriority::Bulk});
+        }
+        globalTasks_.clear();
+    }
+
+    lock_guard<mutex> lock(sleepMtx_);
+    stopping_ = false;
+    queued_ = 0;
+    interactiveQueued_ = 0;
+}
+
+void TaskScheduler::workerLoop(size_t index)
+{
+    currentScheduler = this;
+    currentWorker = index;
+    bool reserved = workers_[index]->reserved;
+
+    // 工作线程上的任何MIRACL运算之前都必须先创建该线程的miracl实例
+    threadPfc();
+
+    for (;;)
+    {
+        QueuedTask queued;
+        if (reserved ? popInteractive(queued) : popTask(index, queued))
+        {
+            runTask(queued.task, queued.priority);
+            continue;
+        }
+
+        unique_lock<mutex> lock(sleepMtx_);
+        if (reserved)
+        {
+            wakeReserved_.wait(lock, [this]() { return stopping_ || interactiveQueued_ > 0; });
+        }
+        else
+        {
+            wakeGeneral_.wait(lock, [this]() { return stopping_ || queued_ > 0 || interactiveQueued_ > 0; });
+        }
+        if (stopping_)
+        {
+            return;
+        }
+    }
+}
+
+bool TaskScheduler::popInteractive(QueuedTask &queued)
+{
+    {
+        lock_guard<mutex> lock(interactiveMtx_);
+        if (interactiveTasks_.empty())
+        {
+            return false;
+        }
+        queued.task = move(interactiveTasks_.front());
+        queued.priority = TaskPriority::Interactive;
+        interactiveTasks_.pop_front();
+    }
+
+    lock_guard<mutex> lock(sleepMtx_);
+    interactiveQueued_--;
+    return true;
+}
+
+bool TaskScheduler::popTask(size_t self, QueuedTask &queued)
+{
+    // 1. 交互队列
+    if (popInteractive(queued))
+    {
+        return true;
+    }
+
+    queued.priority = TaskPriority::Bulk;
+    bool found = false;
+
+    // 2. 自己队列的尾部
+    {
+        Worker &worker = *workers_[self];
+        lock_guard<mutex> lock(worker.mtx);
+        if (!worker.tasks.empty())
+        {
+            queued.task = move(worker.tasks.back());
+            worker.tasks.pop_back();
+            found = true;
+        }
+    }
+
+    // 3. 全局队列
+    if (!found)
+    {
+        lock_guard<mutex> lock(globalMtx_);
+        if (!globalTasks_.empty())
+        {
+            queued.task = move(globalTasks_.front());
+            globalTasks_.pop_front();
+            found = true;
+        }
+    }
+
+    // 4. 从其他工作线程队列的头部窃取
+    for (size_t k = 1; !found && k < workers_.size(); k++)
+    {
+        Worker &victim = *workers_[(self + k) % workers_.size()];
+        lock_guard<mutex> lock(victim.mtx);
+        if (!victim.tasks.empty())
+        {
+            queued.task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        lock_guard<mutex> lock(sleepMtx_);
+        queued_--;
+    }
+    return found;
+}
+
+void TaskScheduler::enqueue(QueuedTask queued)
+{
+    if (queued.priority == TaskPriority::Interactive)
+    {
+        lock_guard<mutex> lock(interactiveMtx_);
+        interactiveTasks_.push_back(move(queued.task));
+    }
+    else
+    {
+        lock_guard<mutex> lock(globalMtx_);
+        globalTasks_.push_back(move(queued.task));
+    }
+    notifyQueued(queued.priority);
+}
+
+void TaskScheduler::notifyQueued(TaskPriority priority)
+{
+    {
+        lock_guard<mutex> lock(sleepMtx_);
+        if (priority == TaskPriority::Interactive)
+        {
+            interactiveQueued_++;
+        }
+        else
+        {
+            queued_++;
+        }
+    }
+
+    // 交互任务优先由预留线程接手，同时唤醒一个普通线程
+    if (priority == TaskPriority::Interactive)
+    {
+        wakeReserved_.notify_one();
+    }
+    wakeGeneral_.notify_one();
+}
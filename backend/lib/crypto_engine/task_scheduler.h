@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 引擎内共享的工作窃取任务调度器
+ *
+ * 进程内所有批量操作(批量注册、群组生成、批量匹配、预计算等)都提交到同一个
+ * 调度器，多个批量接口并发执行时总线程数不会超过配置的工作线程数。
+ *
+ * 每个工作线程持有一个双端队列：工作线程提交的任务压入自己队列的尾部并从尾部
+ * 取出(LIFO，缓存友好)，空闲时从其他线程队列的头部窃取(FIFO)；外部线程提交的
+ * 任务进入全局队列。工作线程启动时先创建本线程的配对上下文。
+ *
+ * 任务分为交互与批量两个优先级。交互任务(资源分配、匹配验证)进入单独的队列，
+ * 所有工作线程优先取交互任务，另有一部分工作线程预留给交互任务、从不执行批量
+ * 任务；批量parallelFor在领取每一块之前检查交互队列，先执行等待中的交互任务，
+ * 以块为粒度让出CPU。
+ *
+ * MIRACL未以多线程方式编译时不启动工作线程，所有任务在提交线程上串行执行。
+ */
+enum class TaskPriority
+{
+    Interactive, // 延迟敏感的请求
+    Bulk         // 批量导入、建组等后台任务
+};
+
+class TaskScheduler
+{
+public:
+    typedef std::function<void()> Task;
+
+    // setWorkerCount的预留线程数取此值时按工作线程总数自动确定
+    static const size_t AUTO_RESERVED = static_cast<size_t>(-1);
+
+    /**
+     * @brief 获取进程内唯一的调度器，首次调用时按硬件并发数启动工作线程
+     */
+    static TaskScheduler &instance();
+
+    ~TaskScheduler();
+
+    /**
+     * @brief 调整工作线程数(不能在调度器的任务内调用)
+     *
+     * 现有工作线程完成手头的任务后退出，尚未执行的任务转交给新的工作线程。
+     *
+     * @param count 工作线程数，0表示所有任务在调用线程上执行
+     * @param reservedInteractive 只执行交互任务的线程数，AUTO_RESERVED表示取总数的1/4(至少1个)
+     * @return 实际生效的工作线程数
+     */
+    size_t setWorkerCount(size_t count, size_t reservedInteractive = AUTO_RESERVED);
+
+    /**
+     * @brief 当前工作线程数
+     */
+    size_t workerCount() const { return activeWorkers_.load(); }
+
+    /**
+     * @brief 预留给交互任务的工作线程数
+     */
+    size_t reservedInteractiveCount() const { return reservedWorkers_.load(); }
+
+    /**
+     * @brief 提交一个任务，没有工作线程时直接在当前线程执行
+     * @param task 任务
+     * @param priority 优先级，默认沿用当前线程的优先级
+     */
+    void submit(Task task);
+    void submit(Task task, TaskPriority priority);
+
+    /**
+     * @brief 在工作线程上先执行所有等待中的交互任务(批量任务的让出点)
+     */
+    void yieldToInteractive();
+
+    /**
+     * @brief 将区间[0, count)切分为若干块，由调用线程与工作线程共同执行
+     *
+     * 调用线程也参与领取块，只等待已被领取且正在执行的块，因此可以在任务内
+     * 嵌套调用而不会死锁。任一块抛出的异常会在调用线程中重新抛出。
+     * 各块按当前线程的优先级(见ScopedTaskPriority)调度。
+     */
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)> &body);
+
+    /**
+     * @brief 默认工作线程数(硬件并发数减去参与执行的调用线程)
+     */
+    static size_t defaultWorkerCount();
+
+    /**
+     * @brief 当前线程的任务优先级(工作线程上为正在执行的任务的优先级)
+     */
+    static TaskPriority currentPriority();
+
+private:
+    TaskScheduler();
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+
+    struct Worker
+    {
+        std::mutex mtx;
+        std::deque<Task> tasks; // 批量任务
+        std::thread thread;
+        bool reserved;          // 是否只执行交互任务
+    };
+
+    struct QueuedTask
+    {
+        Task task;
+        TaskPriority priority;
+    };
+
+    void startWorkers(size_t count, size_t reserved);
+    void stopWorkers(std::vector<QueuedTask> &leftover);
+    void workerLoop(size_t index);
+    bool popInteractive(QueuedTask &task);
+    bool popTask(size_t self, QueuedTask &task);
+    void enqueue(QueuedTask task);
+    void notifyQueued(TaskPriority priority);
+
+    std::mutex controlMtx_; // 串行化工作线程数的调整
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> activeWorkers_;
+    std::atomic<size_t> reservedWorkers_;
+
+    std::mutex globalMtx_;
+    std::deque<Task> globalTasks_; // 外部线程提交的批量任务
+
+    std::mutex interactiveMtx_;
+    std::deque<Task> interactiveTasks_; // 交互任务(所有线程优先领取)
+
+    std::mutex sleepMtx_;
+    std::condition_variable wakeGeneral_;  // 唤醒普通工作线程
+    std::condition_variable wakeReserved_; // 唤醒预留线程
+    long queued_;            // 批量队列中尚未取出的任务数(入队与计数之间可能短暂为负)
+    long interactiveQueued_; // 交互队列中尚未取出的任务数
+    bool stopping_;
+};
+
+/**
+ * @brief 在作用域内设置当前线程提交任务时使用的优先级
+ */
+class ScopedTaskPriority
+{
+public:
+    explicit ScopedTaskPriority(TaskPriority priority);
+    ~ScopedTaskPriority();
+
+private:
+    TaskPriority previous_;
+};
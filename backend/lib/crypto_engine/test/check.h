@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+/**
+ * @brief 独立检查程序共用的断言宏
+ *
+ * 不依赖NDEBUG，失败时打印位置并计数，main末尾以CHECK_EXIT()返回退出码。
+ */
+namespace check
+{
+    inline int &failures()
+    {
+        static int count = 0;
+        return count;
+    }
+}
+
+#define CHECK(cond)                                                                    \
+    do                                                                                 \
+    {                                                                                  \
+        if (!(cond))                                                                   \
+        {                                                                              \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": 检查失败: " #cond << std::endl; \
+            check::failures()++;                                                       \
+        }                                                                              \
+    } while (0)
+
+#define CHECK_EXIT()                                                  \
+    do                                                                \
+    {                                                                 \
+        if (check::failures() != 0)                                   \
+        {                                                             \
+            std::cerr << check::failures() << " 项检查失败" << std::endl; \
+            return EXIT_FAILURE;                                      \
+        }                                                             \
+        std::cout << "ok" << std::endl;                               \
+        return EXIT_SUCCESS;                                          \
+    } while (0)
@@ -0,0 +1,58 @@
+#include "../crypto_engine_impl.h"
+#include "check.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 以新封装与新陷门检查群组公钥自洽：同一关键词匹配，不同关键词不匹配
+static bool consistent(CryptoEngineImpl &engine, const string &groupId, const string &keyword)
+{
+    string record = engine.encapsulateKeyword(keyword, groupId);
+    return engine.verifyKeywordMatch(engine.searchTokenGeneration(keyword, groupId), record) &&
+           !engine.verifyKeywordMatch(engine.searchTokenGeneration(keyword + "#", groupId), record);
+}
+
+// 群组成员重新注册后再退出，平铺与层次群组的 r、Φ 仍与剩余成员一致
+int main()
+{
+    CryptoEngineImpl engine;
+    CHECK(engine.systemSetup(128));
+
+    vector<string> nodeIds;
+    for (int i = 0; i < 200; i++)
+    {
+        nodeIds.push_back("node" + to_string(i));
+    }
+    engine.nodeRegistrationBatch(nodeIds);
+
+    BatchStatus status;
+    string tree = engine.groupGeneration(nodeIds, CancellationToken::none(), status, GroupLayout::Hierarchical);
+    string flat = engine.groupGeneration(vector<string>(nodeIds.begin(), nodeIds.begin() + 20));
+    CHECK(consistent(engine, tree, "a") && consistent(engine, flat, "a"));
+
+    // 单个与批量重新注册(批内重复)，随后退出
+    CHECK(!engine.nodeRegistration("node3").first.empty());
+    engine.nodeRegistrationBatch({"node4", "node150", "node4"});
+    CHECK(consistent(engine, tree, "b") && consistent(engine, flat, "b"));
+    CHECK(engine.groupRemoveMembers(tree, {"node3", "node4", "node150"}));
+    CHECK(engine.groupRemoveMembers(flat, {"node3", "node4"}));
+    CHECK(consistent(engine, tree, "c") && consistent(engine, flat, "c"));
+
+    // 在派生密钥模式与普通模式之间切换后重新注册
+    engine.setDerivedNodeKeys(true, 16);
+    engine.nodeRegistration("node5");
+    engine.nodeRegistration("node160");
+    CHECK(consistent(engine, tree, "d") && consistent(engine, flat, "d"));
+    engine.nodeRegistration("node5");
+    engine.setDerivedNodeKeys(false, 16);
+    engine.nodeRegistration("node160");
+    CHECK(engine.groupRemoveMembers(tree, {"node5", "node160"}));
+    CHECK(engine.groupRemoveMembers(flat, {"node5"}));
+    CHECK(consistent(engine, tree, "e") && consistent(engine, flat, "e"));
+
+    // 重新加入后仍可正常使用
+    CHECK(engine.groupAddMembers(flat, {"node3", "node5"}));
+    CHECK(consistent(engine, flat, "f"));
+    CHECK_EXIT();
+}
@@ -0,0 +1,125 @@
+#include "../task_scheduler.h"
+#include "check.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+// 每个下标恰好被处理一次，且所有区间都落在[0, count)内
+static bool coversOnce(size_t count, size_t grain)
+{
+    unique_ptr<atomic<int>[]> visits(new atomic<int>[count]);
+    for (size_t i = 0; i < count; i++)
+    {
+        visits[i].store(0);
+    }
+    atomic<bool> inRange(true);
+    TaskScheduler::instance().parallelFor(count, grain, [&](size_t begin, size_t end)
+    {
+        if (begin >= end || end > count)
+        {
+            inRange = false;
+            return;
+        }
+        for (size_t i = begin; i < end; i++)
+        {
+            visits[i]++;
+        }
+    });
+    for (size_t i = 0; i < count; i++)
+    {
+        if (visits[i].load() != 1)
+        {
+            return false;
+        }
+    }
+    return inRange.load();
+}
+
+static void checkCoverage()
+{
+    const size_t counts[] = {1, 7, 1000, 100003};
+    const size_t grains[] = {0, 1, 3, 64, 100000};
+    for (size_t count : counts)
+    {
+        for (size_t grain : grains)
+        {
+            CHECK(coversOnce(count, grain));
+        }
+    }
+
+    bool called = false;
+    TaskScheduler::instance().parallelFor(0, 1, [&](size_t, size_t) { called = true; });
+    CHECK(!called);
+}
+
+// 在块内嵌套调用不会死锁，调用线程参与执行
+static void checkNested()
+{
+    atomic<size_t> total(0);
+    TaskScheduler::instance().parallelFor(64, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            TaskScheduler::instance().parallelFor(100, 7, [&](size_t innerBegin, size_t innerEnd)
+            {
+                total += innerEnd - innerBegin;
+            });
+        }
+    });
+    CHECK(total.load() == 64 * 100);
+}
+
+// 块抛出的异常在调用线程中重新抛出，之后调度器仍可使用
+static void checkException()
+{
+    bool caught = false;
+    try
+    {
+        TaskScheduler::instance().parallelFor(1000, 10, [&](size_t begin, size_t end)
+        {
+            if (begin <= 500 && 500 < end)
+            {
+                throw runtime_error("chunk failed");
+            }
+        });
+    }
+    catch (const runtime_error &e)
+    {
+        caught = string(e.what()) == "chunk failed";
+    }
+    CHECK(caught);
+    CHECK(coversOnce(1000, 10));
+}
+
+// 批量优先级、没有工作线程以及调整线程数之后结果不变
+static void checkWorkerCounts()
+{
+    TaskScheduler &scheduler = TaskScheduler::instance();
+    size_t original = scheduler.workerCount();
+    size_t reserved = scheduler.reservedInteractiveCount();
+    {
+        ScopedTaskPriority bulk(TaskPriority::Bulk);
+        CHECK(TaskScheduler::currentPriority() == TaskPriority::Bulk);
+        CHECK(coversOnce(10000, 16));
+    }
+    CHECK(TaskScheduler::currentPriority() == TaskPriority::Interactive);
+
+    CHECK(scheduler.setWorkerCount(0, 0) == 0);
+    CHECK(coversOnce(10000, 16));
+    scheduler.setWorkerCount(3, 1);
+    CHECK(coversOnce(10000, 16));
+    scheduler.setWorkerCount(original, reserved);
+    CHECK(scheduler.workerCount() == original);
+}
+
+int main()
+{
+    checkCoverage();
+    checkNested();
+    checkException();
+    checkWorkerCounts();
+    CHECK_EXIT();
+}
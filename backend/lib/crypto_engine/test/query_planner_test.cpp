@@ -0,0 +1,133 @@
+#include "../keyword_query.h"
+#include "check.h"
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// 不含统计的直接求值，作为短路求值的参照
+static bool naiveEvaluate(const KeywordQuery &query, size_t index, const vector<bool> &terms)
+{
+    const KeywordQuery::Node &node = query.node(index);
+    if (node.op == KeywordQuery::Op::Term)
+    {
+        return terms[node.term];
+    }
+    bool isAnd = node.op == KeywordQuery::Op::And;
+    bool result = isAnd;
+    for (size_t child : node.children)
+    {
+        result = isAnd ? (result && naiveEvaluate(query, child, terms)) : (result || naiveEvaluate(query, child, terms));
+    }
+    return result;
+}
+
+// 缺少根、空的组合节点与引用未添加的子节点都不是完整的查询
+static void checkValidity()
+{
+    KeywordQuery query;
+    CHECK(!query.valid());
+    size_t a = query.addTerm(0);
+    size_t b = query.addTerm(3);
+    query.setRoot(query.addAnd({a, b}));
+    CHECK(query.valid() && query.termCount() == 4);
+
+    KeywordQuery empty;
+    empty.setRoot(empty.addOr({}));
+    CHECK(!empty.valid());
+
+    KeywordQuery forward;
+    forward.addTerm(0);
+    forward.setRoot(forward.addAnd({0, 5}));
+    CHECK(!forward.valid());
+}
+
+// AND先求最可能不匹配的项，OR先求最可能匹配的项，短路后不再求其余项
+static void checkOrdering()
+{
+    KeywordQuery query;
+    size_t rare = query.addTerm(0);
+    size_t common = query.addTerm(1);
+    size_t conj = query.addAnd({common, rare});
+    size_t disj = query.addOr({rare, common});
+    query.setRoot(query.addOr({conj, disj}));
+
+    QueryPlanner planner(query);
+    for (int i = 0; i < 100; i++)
+    {
+        planner.record(0, i < 5);
+        planner.record(1, i < 95);
+    }
+    QueryPlanner::Plan plan = planner.plan();
+    CHECK(plan[conj] == vector<size_t>({rare, common}));
+    CHECK(plan[disj] == vector<size_t>({common, rare}));
+    CHECK(plan[query.root()] == vector<size_t>({disj, conj}));
+
+    // 根OR先求disj，其中common匹配后整个查询短路
+    vector<size_t> evaluated;
+    bool matched = planner.evaluate(plan, [&](size_t term)
+    {
+        evaluated.push_back(term);
+        return term == 1;
+    });
+    CHECK(matched && evaluated == vector<size_t>({1}));
+}
+
+// 随机查询与随机统计下，任意求值顺序的结果都与直接求值一致
+static void checkAgainstNaive()
+{
+    mt19937 rng(7);
+    for (int round = 0; round < 300; round++)
+    {
+        size_t termCount = 1 + rng() % 6;
+        KeywordQuery query;
+        vector<size_t> pool;
+        for (size_t t = 0; t < termCount; t++)
+        {
+            pool.push_back(query.addTerm(t));
+        }
+        size_t groups = rng() % 6;
+        for (size_t g = 0; g < groups; g++)
+        {
+            vector<size_t> children;
+            size_t arity = 1 + rng() % 3;
+            for (size_t c = 0; c < arity; c++)
+            {
+                children.push_back(pool[rng() % pool.size()]);
+            }
+            pool.push_back(rng() % 2 ? query.addAnd(children) : query.addOr(children));
+        }
+        query.setRoot(pool.back());
+        CHECK(query.valid());
+
+        QueryPlanner planner(query);
+        for (size_t t = 0; t < termCount; t++)
+        {
+            size_t evaluations = rng() % 20;
+            for (size_t i = 0; i < evaluations; i++)
+            {
+                planner.record(t, rng() % 2 == 0);
+            }
+        }
+        QueryPlanner::Plan plan = planner.plan();
+
+        vector<bool> terms(termCount);
+        for (size_t t = 0; t < termCount; t++)
+        {
+            terms[t] = rng() % 2 == 0;
+        }
+        bool planned = planner.evaluate(plan, [&](size_t term)
+        {
+            return terms[term];
+        });
+        CHECK(planned == naiveEvaluate(query, query.root(), terms));
+    }
+}
+
+int main()
+{
+    checkValidity();
+    checkOrdering();
+    checkAgainstNaive();
+    CHECK_EXIT();
+}
@@ -0,0 +1,62 @@
+#!/bin/sh
+# 编译并运行crypto_engine的独立检查程序
+set -e
+
+cd "$(dirname "$0")"
+SRC=..
+OUT=${TEST_OUT:-build}
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:-"-std=c++17 -O1 -g"}
+mkdir -p "$OUT"
+
+failed=0
+
+# run 名称 源文件...
+run()
+{
+    name=$1
+    shift
+    echo "== $name"
+    if $CXX $CXXFLAGS -pthread -o "$OUT/$name" "$@" && "$OUT/$name"; then
+        :
+    else
+        failed=1
+    fi
+}
+
+# runjs 名称 脚本
+runjs()
+{
+    echo "== $1"
+    if ! node "$2"; then
+        failed=1
+    fi
+}
+
+run unique_id_test unique_id_test.cpp $SRC/unique_id.cpp
+run striped_lru_cache_test striped_lru_cache_test.cpp
+run top_k_collector_test top_k_collector_test.cpp $SRC/allocation_policy.cpp
+run query_planner_test query_planner_test.cpp $SRC/keyword_query.cpp
+
+if command -v node >/dev/null 2>&1; then
+    runjs verify_coalescer_test verify_coalescer_test.js
+else
+    echo "未找到node，跳过JavaScript检查"
+fi
+
+# 依赖MIRACL的检查：MIRACL_LIB指向编译好的静态库(含SS2配对实现)时运行
+ENGINE_SRC="$SRC/crypto_engine_impl.cpp $SRC/unique_id.cpp $SRC/match_cache.cpp $SRC/pairing_context.cpp
+    $SRC/parallel_for.cpp $SRC/point_accumulator.cpp $SRC/compressed_gt.cpp $SRC/task_scheduler.cpp
+    $SRC/allocation_policy.cpp $SRC/cancellation.cpp $SRC/keyword_query.cpp $SRC/group_tree.cpp"
+if [ -n "$MIRACL_LIB" ] && [ -f "$MIRACL_LIB" ]; then
+    MIRACL_FLAGS="-DMR_PAIRING_SS2 -DAES_SECURITY=128"
+    run parallel_for_test $MIRACL_FLAGS parallel_for_test.cpp $SRC/task_scheduler.cpp $SRC/pairing_context.cpp "$MIRACL_LIB"
+    run group_reregistration_test $MIRACL_FLAGS group_reregistration_test.cpp $ENGINE_SRC "$MIRACL_LIB"
+else
+    echo "未设置MIRACL_LIB，跳过依赖MIRACL的检查"
+fi
+
+if [ "$failed" -ne 0 ]; then
+    echo "存在失败的检查"
+    exit 1
+fi
@@ -0,0 +1,104 @@
+#include "../striped_lru_cache.h"
+#include "check.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 所有键落入同一分段，便于精确检查单个分段的LRU顺序
+struct SameStripeHash
+{
+    size_t operator()(int) const { return 0; }
+};
+
+typedef StripedLruCache<int, string, SameStripeHash> SingleStripeCache;
+
+// 单个分段按最近使用顺序淘汰，find会刷新顺序，contains不会
+static void checkLruOrder()
+{
+    vector<int> evicted;
+    SingleStripeCache cache(3 * SingleStripeCache::STRIPES, [&](const int &key, const string &)
+    {
+        evicted.push_back(key);
+    });
+
+    cache.insert(1, "a");
+    cache.insert(2, "b");
+    cache.insert(3, "c");
+    string value;
+    CHECK(cache.find(1, value) && value == "a");
+    CHECK(cache.contains(2));
+
+    cache.insert(4, "d"); // 最久未使用的是2
+    CHECK(evicted == vector<int>({2}));
+    CHECK(!cache.contains(2) && cache.contains(1) && cache.contains(3) && cache.contains(4));
+
+    // 覆盖已有键不淘汰
+    cache.insert(3, "c2");
+    CHECK(evicted.size() == 1 && cache.find(3, value) && value == "c2");
+    CHECK(cache.size() == 3);
+
+    // 显式删除与清空不触发回调
+    CHECK(cache.erase(1));
+    CHECK(!cache.erase(1));
+    cache.clear();
+    CHECK(cache.size() == 0 && evicted.size() == 1);
+}
+
+// 缩小容量时立即淘汰超出部分并逐个回调
+static void checkShrink()
+{
+    vector<int> evicted;
+    SingleStripeCache cache(4 * SingleStripeCache::STRIPES, [&](const int &key, const string &)
+    {
+        evicted.push_back(key);
+    });
+    for (int i = 0; i < 4; i++)
+    {
+        cache.insert(i, to_string(i));
+    }
+    cache.setCapacity(SingleStripeCache::STRIPES);
+    CHECK(cache.size() == 1 && cache.contains(3));
+    CHECK(evicted == vector<int>({0, 1, 2}));
+}
+
+// 并发写入后总数不超过容量，每个被淘汰的键恰好回调一次
+static void checkConcurrentBound()
+{
+    const size_t capacity = 256;
+    const int threads = 8;
+    const int perThread = 2000;
+    atomic<size_t> evictions(0);
+    StripedLruCache<int, int> cache(capacity, [&](const int &, const int &)
+    {
+        evictions++;
+    });
+
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]()
+        {
+            for (int i = 0; i < perThread; i++)
+            {
+                cache.insert(t * perThread + i, i);
+            }
+        });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    CHECK(cache.size() <= capacity);
+    CHECK(evictions.load() + cache.size() == static_cast<size_t>(threads * perThread));
+}
+
+int main()
+{
+    checkLruOrder();
+    checkShrink();
+    checkConcurrentBound();
+    CHECK_EXIT();
+}
@@ -0,0 +1,126 @@
+#include "../allocation_policy.h"
+#include "check.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// 逐个比较收集结果与期望的(槽位, 候选下标)序列
+static bool sameEntries(const vector<TopKCollector::Entry> &entries, const vector<pair<size_t, size_t>> &expected)
+{
+    if (entries.size() != expected.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].slot != expected[i].first || entries[i].index != expected[i].second)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 键相同按槽位排序，同一槽位保留最小下标，不可选(无穷大)与k=0不收集
+static void checkBasics()
+{
+    TopKCollector collector(3);
+    collector.offer(2.0, 0, 0);
+    collector.offer(1.0, 1, 5);
+    collector.offer(1.0, 2, 2);
+    collector.offer(1.0, 1, 3); // 同一槽位再次出现
+    collector.offer(0.5, 3, 4); // 挤掉当前第3名(槽位0)
+    collector.offer(numeric_limits<double>::infinity(), 4, 6);
+    CHECK(sameEntries(collector.sorted(), {{3, 4}, {1, 3}, {2, 2}}));
+
+    TopKCollector none(0);
+    none.offer(0.0, 0, 0);
+    CHECK(none.sorted().empty());
+}
+
+// 随机输入下，整体收集以及分块收集后合并都与排序后取前k名一致
+static void checkAgainstSort()
+{
+    mt19937 rng(42);
+    for (int round = 0; round < 200; round++)
+    {
+        size_t slots = 1 + rng() % 50;
+        size_t candidates = 1 + rng() % 200;
+        size_t k = rng() % 12;
+
+        vector<double> keys(slots);
+        for (double &key : keys)
+        {
+            key = (rng() % 8 == 0) ? numeric_limits<double>::infinity() : static_cast<double>(rng() % 10);
+        }
+        vector<size_t> slotOf(candidates);
+        vector<size_t> firstIndex(slots, candidates);
+        for (size_t i = 0; i < candidates; i++)
+        {
+            slotOf[i] = rng() % slots;
+            firstIndex[slotOf[i]] = min(firstIndex[slotOf[i]], i);
+        }
+
+        vector<size_t> order;
+        for (size_t slot = 0; slot < slots; slot++)
+        {
+            if (firstIndex[slot] < candidates && keys[slot] != numeric_limits<double>::infinity())
+            {
+                order.push_back(slot);
+            }
+        }
+        sort(order.begin(), order.end(), [&](size_t a, size_t b)
+        {
+            return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+        });
+        vector<pair<size_t, size_t>> expected;
+        for (size_t i = 0; i < min(k, order.size()); i++)
+        {
+            expected.push_back(make_pair(order[i], firstIndex[order[i]]));
+        }
+
+        TopKCollector whole(k);
+        vector<TopKCollector> parts(4, TopKCollector(k));
+        for (size_t i = 0; i < candidates; i++)
+        {
+            whole.offer(keys[slotOf[i]], slotOf[i], i);
+            parts[i % parts.size()].offer(keys[slotOf[i]], slotOf[i], i);
+        }
+        TopKCollector merged(k);
+        for (const TopKCollector &part : parts)
+        {
+            merged.merge(part);
+        }
+        CHECK(sameEntries(whole.sorted(), expected));
+        CHECK(sameEntries(merged.sorted(), expected));
+    }
+}
+
+// 负载最低策略的排序键与select的选择一致，select记入需求后排序随之改变
+static void checkRanking()
+{
+    AllocationPolicyEngine engine;
+    engine.setPolicy(AllocationPolicyKind::LeastLoaded);
+    engine.updateNodeLoads({"a", "b", "c"}, {{5, 10, 1}, {1, 10, 1}, {3, 10, 1}});
+
+    vector<string> candidates = {"a", "b", "a", "c"};
+    AllocationRanking ranking = engine.rank(candidates);
+    CHECK(ranking.slotNodes == vector<string>({"a", "b", "c"}));
+    CHECK(ranking.slotOf == vector<size_t>({0, 1, 0, 2}));
+    CHECK(ranking.keys[1] < ranking.keys[2] && ranking.keys[2] < ranking.keys[0]);
+
+    CHECK(engine.select(candidates, 3.0) == 1); // b: 1 -> 4
+    ranking = engine.rank(candidates);
+    CHECK(ranking.keys[2] < ranking.keys[1]);
+}
+
+int main()
+{
+    checkBasics();
+    checkAgainstSort();
+    checkRanking();
+    CHECK_EXIT();
+}
@@ -0,0 +1,91 @@
+#include "../unique_id.h"
+#include "check.h"
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// 二进制与文本编码往返一致，且编码的字典序与数值序一致
+static void checkEncoding()
+{
+    vector<UniqueId> ids = {UniqueId(0, 0), UniqueId(0, 1), UniqueId(0, ~0ULL), UniqueId(1, 0),
+                            UniqueId(0x0123456789ABCDEFULL, 0xFEDCBA9876543210ULL), UniqueId(~0ULL, ~0ULL)};
+    for (const UniqueId &id : ids)
+    {
+        unsigned char buf[UniqueId::BINARY_SIZE];
+        id.toBinary(buf);
+        CHECK(UniqueId::fromBinary(buf) == id);
+
+        string text = id.toString();
+        CHECK(text.size() == UniqueId::TEXT_SIZE);
+        UniqueId parsed;
+        CHECK(UniqueId::fromString(text, parsed) && parsed == id);
+    }
+    for (size_t i = 1; i < ids.size(); i++)
+    {
+        CHECK(ids[i - 1] < ids[i]);
+        CHECK(ids[i - 1].toString() < ids[i].toString());
+    }
+
+    // 小写与Crockford易混淆字符按规范解析
+    UniqueId id(0x0123456789ABCDEFULL, 0xFEDCBA9876543210ULL);
+    string lower = id.toString();
+    transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    UniqueId parsed;
+    CHECK(UniqueId::fromString(lower, parsed) && parsed == id);
+    CHECK(UniqueId::fromString(string(25, '0') + "O", parsed) && parsed == UniqueId(0, 0));
+    CHECK(UniqueId::fromString(string(25, '0') + "I", parsed) && parsed == UniqueId(0, 1));
+    CHECK(UniqueId::fromString(string(25, '0') + "L", parsed) && parsed == UniqueId(0, 1));
+
+    // 长度错误、非法字符与超出128位的首字符均被拒绝
+    CHECK(!UniqueId::fromString("", parsed));
+    CHECK(!UniqueId::fromString(string(25, '0'), parsed));
+    CHECK(!UniqueId::fromString(string(27, '0'), parsed));
+    CHECK(!UniqueId::fromString(string(25, '0') + "U", parsed));
+    CHECK(!UniqueId::fromString("8" + string(25, '0'), parsed));
+    CHECK(UniqueId::fromString("7" + string(25, 'Z'), parsed) && parsed == UniqueId(~0ULL, ~0ULL));
+}
+
+// 多线程并发生成的ID互不重复，节点标记只改变前缀的高16位
+static void checkGenerator()
+{
+    UniqueIdGenerator &generator = UniqueIdGenerator::instance();
+    uint64_t epoch = generator.prefix() & ((1ULL << 48) - 1);
+    generator.setNodeTag(0xBEEF);
+    CHECK(generator.prefix() == ((0xBEEFULL << 48) | epoch));
+    CHECK(generator.next().high == generator.prefix());
+
+    const int threads = 8;
+    const int perThread = 10000;
+    set<UniqueId> seen;
+    mutex seenMtx;
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&]()
+        {
+            vector<UniqueId> local;
+            for (int i = 0; i < perThread; i++)
+            {
+                local.push_back(generator.next());
+            }
+            lock_guard<mutex> lock(seenMtx);
+            seen.insert(local.begin(), local.end());
+        });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    CHECK(seen.size() == static_cast<size_t>(threads * perThread));
+}
+
+int main()
+{
+    checkEncoding();
+    checkGenerator();
+    CHECK_EXIT();
+}
@@ -0,0 +1,95 @@
+/**
+ * VerifyCoalescer的独立检查，以记录调用的假引擎代替原生CryptoEngine
+ */
+const assert = require("assert");
+const VerifyCoalescer = require("../verify_coalescer");
+
+// 记录每次批量调用；元数据与陷门相同视为匹配，"fail"使整批失败，"throw"同步抛出
+function fakeEngine() {
+    const batches = [];
+    return {
+        batches,
+        verifyKeywordMatchBatchAsync(trapdoors, metadataList) {
+            batches.push(trapdoors.slice());
+            if (trapdoors.includes("throw")) {
+                throw new Error("sync failure");
+            }
+            if (trapdoors.includes("fail")) {
+                return Promise.reject(new Error("batch failure"));
+            }
+            return Promise.resolve({ results: trapdoors.map((t, i) => (t === metadataList[i] ? 1 : 0)) });
+        },
+    };
+}
+
+// 窗口内到达的请求合并为一批，各自得到对应的结果
+async function checkWindow() {
+    const engine = fakeEngine();
+    const coalescer = new VerifyCoalescer(engine, { windowMs: 5 });
+    const results = await Promise.all([
+        coalescer.verify("a", "a"),
+        coalescer.verify("b", "x"),
+        coalescer.verify("c", "c"),
+    ]);
+    assert.deepStrictEqual(results, [true, false, true]);
+    assert.deepStrictEqual(engine.batches, [["a", "b", "c"]]);
+}
+
+// 攒满maxBatchSize立即提交，剩余请求等窗口结束
+async function checkMaxBatchSize() {
+    const engine = fakeEngine();
+    const coalescer = new VerifyCoalescer(engine, { windowMs: 5, maxBatchSize: 2 });
+    const pending = ["a", "b", "c", "d", "e"].map((t) => coalescer.verify(t, t));
+    assert.strictEqual(engine.batches.length, 0); // 提交在微任务中进行
+    await Promise.resolve();
+    assert.deepStrictEqual(engine.batches, [["a", "b"], ["c", "d"]]);
+    assert.deepStrictEqual(await Promise.all(pending), [true, true, true, true, true]);
+    assert.deepStrictEqual(engine.batches, [["a", "b"], ["c", "d"], ["e"]]);
+}
+
+// 批量失败(异步拒绝或同步抛出)时同批请求全部拒绝，之后的批次不受影响
+async function checkFailures() {
+    const engine = fakeEngine();
+    const coalescer = new VerifyCoalescer(engine, { windowMs: 1 });
+    for (const [bad, message] of [["fail", "batch failure"], ["throw", "sync failure"]]) {
+        const outcomes = await Promise.all(
+            [coalescer.verify("a", "a"), coalescer.verify(bad, bad)].map((p) =>
+                p.then(() => "resolved", (error) => error.message)
+            )
+        );
+        assert.deepStrictEqual(outcomes, [message, message]);
+    }
+    assert.strictEqual(await coalescer.verify("z", "z"), true);
+}
+
+// 手动flush立即提交并取消计时器，空队列flush不调用引擎
+async function checkFlush() {
+    const engine = fakeEngine();
+    const coalescer = new VerifyCoalescer(engine, { windowMs: 60000 });
+    const result = coalescer.verify("a", "a");
+    coalescer.flush();
+    assert.strictEqual(coalescer.timer, null);
+    assert.strictEqual(await result, true);
+    coalescer.flush();
+    assert.strictEqual(engine.batches.length, 1);
+}
+
+function checkOptions() {
+    const engine = fakeEngine();
+    assert.throws(() => new VerifyCoalescer(engine, { windowMs: -1 }));
+    assert.throws(() => new VerifyCoalescer(engine, { windowMs: NaN }));
+    assert.throws(() => new VerifyCoalescer(engine, { maxBatchSize: 0 }));
+    assert.throws(() => new VerifyCoalescer(engine, { maxBatchSize: 1.5 }));
+}
+
+(async () => {
+    checkOptions();
+    await checkWindow();
+    await checkMaxBatchSize();
+    await checkFailures();
+    await checkFlush();
+    console.log("ok");
+})().catch((error) => {
+    console.error(error);
+    process.exit(1);
+});
@@ -0,0 +1,138 @@
+#include "unique_id.h"
+#include <chrono>
+#include <random>
+
+using namespace std;
+
+namespace
+{
+    // Crockford Base32字母表(去除易混淆的I、L、O、U)
+    const char BASE32_ALPHABET[] = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+
+    int decodeBase32Char(char c)
+    {
+        if (c >= 'a' && c <= 'z')
+        {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        // 兼容Crockford规范中的易混淆字符
+        if (c == 'O')
+        {
+            c = '0';
+        }
+        else if (c == 'I' || c == 'L')
+        {
+            c = '1';
+        }
+        for (int i = 0; i < 32; i++)
+        {
+            if (BASE32_ALPHABET[i] == c)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // 纪元占用前缀的低48位
+    const uint64_t EPOCH_MASK = (1ULL << 48) - 1;
+}
+
+void UniqueId::toBinary(unsigned char *out) const
+{
+    for (int i = 0; i < 8; i++)
+    {
+        out[i] = static_cast<unsigned char>(high >> (56 - 8 * i));
+        out[8 + i] = static_cast<unsigned char>(low >> (56 - 8 * i));
+    }
+}
+
+UniqueId UniqueId::fromBinary(const unsigned char *in)
+{
+    UniqueId id;
+    for (int i = 0; i < 8; i++)
+    {
+        id.high = (id.high << 8) | in[i];
+        id.low = (id.low << 8) | in[8 + i];
+    }
+    return id;
+}
+
+string UniqueId::toString() const
+{
+    // 128位按5位一组从低位向高位编码，最高位字符只携带3位
+    char buf[TEXT_SIZE];
+    uint64_t h = high;
+    uint64_t l = low;
+    for (int i = TEXT_SIZE - 1; i >= 0; i--)
+    {
+        buf[i] = BASE32_ALPHABET[l & 31];
+        l = (l >> 5) | (h << 59);
+        h >>= 5;
+    }
+    return string(buf, TEXT_SIZE);
+}
+
+bool UniqueId::fromString(const string &text, UniqueId &id)
+{
+    if (text.size() != TEXT_SIZE)
+    {
+        return false;
+    }
+
+    uint64_t h = 0;
+    uint64_t l = 0;
+    for (size_t i = 0; i < TEXT_SIZE; i++)
+    {
+        int digit = decodeBase32Char(text[i]);
+        // 首字符只能携带3位，超出即溢出128位
+        if (digit < 0 || (i == 0 && digit > 7))
+        {
+            return false;
+        }
+        h = (h << 5) | (l >> 59);
+        l = (l << 5) | static_cast<uint64_t>(digit);
+    }
+
+    id.high = h;
+    id.low = l;
+    return true;
+}
+
+UniqueIdGenerator &UniqueIdGenerator::instance()
+{
+    static UniqueIdGenerator generator;
+    return generator;
+}
+
+UniqueIdGenerator::UniqueIdGenerator() : prefix_(0), nextBlock_(0)
+{
+    // 纪元取进程启动时的毫秒时间戳，节点标记默认随机选取
+    uint64_t epochMs = static_cast<uint64_t>(chrono::duration_cast<chrono::milliseconds>(
+                                                 chrono::system_clock::now().time_since_epoch())
+                                                 .count());
+    random_device rd;
+    uint16_t nodeTag = static_cast<uint16_t>(rd());
+    prefix_.store((static_cast<uint64_t>(nodeTag) << 48) | (epochMs & EPOCH_MASK), memory_order_relaxed);
+}
+
+void UniqueIdGenerator::setNodeTag(uint16_t nodeTag)
+{
+    uint64_t current = prefix_.load(memory_order_relaxed);
+    prefix_.store((static_cast<uint64_t>(nodeTag) << 48) | (current & EPOCH_MASK), memory_order_relaxed);
+}
+
+UniqueId UniqueIdGenerator::next()
+{
+    // 线程私有的计数块 [blockNext, blockEnd)
+    thread_local uint64_t blockNext = 0;
+    thread_local uint64_t blockEnd = 0;
+
+    if (blockNext == blockEnd)
+    {
+        blockNext = nextBlock_.fetch_add(BLOCK_SIZE, memory_order_relaxed);
+        blockEnd = blockNext + BLOCK_SIZE;
+    }
+
+    return UniqueId(prefix_.load(memory_order_relaxed), blockNext++);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <atomic>
+
+/**
+ * @brief 128位唯一标识符
+ *
+ * 高64位为前缀：16位节点标记 + 48位纪元(进程启动时的毫秒时间戳)，
+ * 低64位为进程内单调递增的计数器。
+ */
+struct UniqueId
+{
+    uint64_t high;
+    uint64_t low;
+
+    UniqueId() : high(0), low(0) {}
+    UniqueId(uint64_t h, uint64_t l) : high(h), low(l) {}
+
+    bool operator==(const UniqueId &other) const { return high == other.high && low == other.low; }
+    bool operator!=(const UniqueId &other) const { return !(*this == other); }
+    bool operator<(const UniqueId &other) const
+    {
+        return high < other.high || (high == other.high && low < other.low);
+    }
+
+    // 二进制编码长度(字节)
+    static const size_t BINARY_SIZE = 16;
+    // 文本编码长度(Crockford Base32字符数)
+    static const size_t TEXT_SIZE = 26;
+
+    /**
+     * @brief 紧凑二进制编码(大端序，字节序与数值序一致)
+     * @param out 至少16字节的输出缓冲区
+     */
+    void toBinary(unsigned char *out) const;
+
+    /**
+     * @brief 从二进制编码解析
+     * @param in 16字节输入缓冲区
+     */
+    static UniqueId fromBinary(const unsigned char *in);
+
+    /**
+     * @brief 紧凑文本编码(26个Crockford Base32字符，字典序与数值序一致)
+     */
+    std::string toString() const;
+
+    /**
+     * @brief 从文本编码解析
+     * @param text 输入文本
+     * @param id 解析结果
+     * @return 是否解析成功
+     */
+    static bool fromString(const std::string &text, UniqueId &id);
+};
+
+// 供unordered_map使用的哈希函数
+struct UniqueIdHash
+{
+    size_t operator()(const UniqueId &id) const
+    {
+        uint64_t h = id.high * 0x9E3779B97F4A7C15ULL ^ id.low;
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+};
+
+/**
+ * @brief 无锁唯一ID生成器
+ *
+ * 每个线程从全局原子计数器一次性领取一个计数块，块内分配无需任何同步，
+ * 因此同一进程内生成的ID绝不重复；节点标记与纪元前缀区分不同进程/实例。
+ * 节点标记默认随机选取，多实例部署时应由systemSetup的nodeTag参数(JS侧为选项nodeTag或
+ * 环境变量CRYPTO_ENGINE_NODE_TAG)为每个进程配置不同的值，否则同一毫秒启动的两个进程可能重复。
+ */
+class UniqueIdGenerator
+{
+public:
+    /**
+     * @brief 获取进程级单例
+     */
+    static UniqueIdGenerator &instance();
+
+    /**
+     * @brief 生成下一个唯一ID
+     */
+    UniqueId next();
+
+    /**
+     * @brief 设置节点标记(多实例部署时用于区分不同后端进程)
+     * @param nodeTag 16位节点标记
+     */
+    void setNodeTag(uint16_t nodeTag);
+
+    /**
+     * @brief 获取当前前缀(节点标记 + 纪元)
+     */
+    uint64_t prefix() const { return prefix_.load(std::memory_order_relaxed); }
+
+private:
+    UniqueIdGenerator();
+
+    UniqueIdGenerator(const UniqueIdGenerator &) = delete;
+    UniqueIdGenerator &operator=(const UniqueIdGenerator &) = delete;
+
+    // 每次领取的计数块大小
+    static const uint64_t BLOCK_SIZE = 4096;
+
+    std::atomic<uint64_t> prefix_;
+    std::atomic<uint64_t> nextBlock_;
+};
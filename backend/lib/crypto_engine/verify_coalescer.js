@@ -0,0 +1,75 @@
+/**
+ * 关键词匹配验证的微批合并器
+ * 在一个很短的时间窗口内收集逐条到达的验证请求(或攒满一批后立即提交)，
+ * 合并为一次批量验证交给原生引擎并行执行，再分别兑现各调用方的Promise
+ */
+class VerifyCoalescer {
+    /**
+     * @param {Object} engine 原生CryptoEngine实例
+     * @param {Object} [options]
+     * @param {number} [options.windowMs=2] 收集窗口(毫秒)
+     * @param {number} [options.maxBatchSize=256] 单批最多合并的请求数
+     */
+    constructor(engine, { windowMs = 2, maxBatchSize = 256 } = {}) {
+        if (!Number.isFinite(windowMs) || windowMs < 0) {
+            throw new Error("合并窗口必须是非负数");
+        }
+        if (!Number.isInteger(maxBatchSize) || maxBatchSize < 1) {
+            throw new Error("批大小必须是正整数");
+        }
+
+        this.engine = engine;
+        this.windowMs = windowMs;
+        this.maxBatchSize = maxBatchSize;
+        this.pending = [];
+        this.timer = null;
+    }
+
+    /**
+     * 提交一条验证请求
+     * @param {string} trapdoor 陷门
+     * @param {string} encryptedMetadata 加密元数据
+     * @returns {Promise<boolean>} 该请求的匹配结果
+     */
+    verify(trapdoor, encryptedMetadata) {
+        return new Promise((resolve, reject) => {
+            this.pending.push({ trapdoor, encryptedMetadata, resolve, reject });
+
+            if (this.pending.length >= this.maxBatchSize) {
+                this.flush();
+            } else if (!this.timer) {
+                this.timer = setTimeout(() => this.flush(), this.windowMs);
+            }
+        });
+    }
+
+    /**
+     * 立即提交当前收集到的全部请求
+     */
+    flush() {
+        if (this.timer) {
+            clearTimeout(this.timer);
+            this.timer = null;
+        }
+        if (this.pending.length === 0) {
+            return;
+        }
+
+        const batch = this.pending;
+        this.pending = [];
+
+        const trapdoors = batch.map((request) => request.trapdoor);
+        const metadataList = batch.map((request) => request.encryptedMetadata);
+
+        Promise.resolve()
+            .then(() => this.engine.verifyKeywordMatchBatchAsync(trapdoors, metadataList))
+            .then(({ results }) => {
+                batch.forEach((request, i) => request.resolve(Boolean(results[i])));
+            })
+            .catch((error) => {
+                batch.forEach((request) => request.reject(error));
+            });
+    }
+}
+
+module.exports = VerifyCoalescer;